@@ -0,0 +1,70 @@
+#include <libpq-fe.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/time.h>
+#include "../../src/drivers/pg/bytea.h"
+
+using namespace dbi;
+
+double now() {
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+// bytea hex decoding, PQunescapeBytea vs PQ_BYTEA_DECODE on blobs from 1KB to 16MB.
+int main(int argc, char *argv[]) {
+    const char *hex = "0123456789abcdef";
+    uint64_t size, total = 64 * 1024 * 1024;
+    unsigned char *buffer = 0;
+    uint64_t buffer_size = 0;
+
+    printf("%10s %10s %14s %14s\n", "size", "iter", "libpq MB/s", "dbic++ MB/s");
+
+    for (size = 1024; size <= 16 * 1024 * 1024; size *= 4) {
+        uint64_t n, iter = total / size;
+        unsigned char *text = new unsigned char[size * 2 + 3];
+
+        text[0] = '\\';
+        text[1] = 'x';
+        for (n = 0; n < size; n++) {
+            int byte = rand() & 0xff;
+            text[2 + n*2]     = hex[byte >> 4];
+            text[2 + n*2 + 1] = hex[byte & 0x0f];
+        }
+        text[size * 2 + 2] = 0;
+
+        size_t len;
+        unsigned char *expected = PQunescapeBytea(text, &len);
+        if (PQ_BYTEA_DECODE(text, size * 2 + 2, &buffer, &buffer_size) != (int64_t)len
+            || memcmp(buffer, expected, len)) {
+            fprintf(stderr, "decoded value mismatch at %lu bytes\n", (unsigned long)size);
+            return 1;
+        }
+        PQfreemem(expected);
+
+        double start = now();
+        for (n = 0; n < iter; n++) {
+            PQfreemem(PQunescapeBytea(text, &len));
+        }
+        double libpq = now() - start;
+
+        start = now();
+        for (n = 0; n < iter; n++) {
+            if (PQ_BYTEA_DECODE(text, size * 2 + 2, &buffer, &buffer_size) != (int64_t)size) {
+                fprintf(stderr, "decode failed\n");
+                return 1;
+            }
+        }
+        double dbicpp = now() - start;
+
+        printf("%10lu %10lu %14.1f %14.1f\n", (unsigned long)size, (unsigned long)iter,
+            total / libpq / 1048576, total / dbicpp / 1048576);
+
+        delete [] text;
+    }
+
+    delete [] buffer;
+    return 0;
+}
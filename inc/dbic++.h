@@ -8,11 +8,14 @@
 #include <cstdio>
 #include <vector>
 #include <map>
+#include <deque>
+#include <pthread.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <dirent.h>
 #include <dlfcn.h>
 #include <pcrecpp.h>
@@ -40,6 +43,7 @@ namespace dbi {
 #include "dbic++/container.h"
 namespace dbi {
     typedef dbi::FieldSet field_list_t;
+    typedef std::vector<dbi::ResultRow> row_list_t;
 }
 
 #define DEFAULT_DRIVER_PATH "/usr/lib/dbic++"
@@ -58,6 +62,9 @@ namespace dbi {
 namespace dbi {
     extern bool _trace;
     extern int  _trace_fd;
+    extern uint64_t _slow_query_threshold;
+    extern bool _phase_timing;
+    extern bool _observed;
 
     class AbstractStatement;
     class AbstractResult;
@@ -67,6 +74,18 @@ namespace dbi {
 #include "dbic++/io.h"
 #include "dbic++/string_io.h"
 #include "dbic++/file_io.h"
+#include "dbic++/mmap_io.h"
+#include "dbic++/compressed_io.h"
+#include "dbic++/tsv_writer.h"
+#include "dbic++/row_source.h"
+#include "dbic++/value.h"
+#include "dbic++/histogram.h"
+#include "dbic++/stats.h"
+#include "dbic++/slow_query.h"
+#include "dbic++/phase_timer.h"
+#include "dbic++/observer.h"
+#include "dbic++/metrics.h"
+#include "dbic++/fetch_context.h"
 #include "dbic++/abstract_handle.h"
 #include "dbic++/abstract_result.h"
 #include "dbic++/abstract_statement.h"
@@ -74,6 +93,8 @@ namespace dbi {
 #include "dbic++/statement.h"
 #include "dbic++/result.h"
 #include "dbic++/query.h"
+#include "dbic++/parallel_loader.h"
+#include "dbic++/copy.h"
 #include "dbic++/etc.h"
 
 #endif
@@ -155,6 +155,54 @@ namespace dbi {
         */
         virtual uint64_t write(std::string table, FieldSet &fields, IO*) = 0;
 
+        /*
+            Function: write(string, FieldSet&, row_list_t&)
+            Bulk write typed rows into a database table. Unlike <write(string, FieldSet&, IO*)>
+            values need no escaping, each <Param> in a row is loaded as is and a null <Param>
+            is loaded as NULL.
+
+            Parameters:
+            table  - table name.
+            fields - field names, all table columns if empty.
+            rows   - rows to write, each with a value for every field.
+
+            Returns:
+            rows   - The number of rows written to database.
+        */
+        virtual uint64_t write(std::string table, FieldSet &fields, row_list_t &rows) = 0;
+
+        /*
+            Function: writeRows(string, FieldSet&, RowSource&)
+            Bulk write typed rows pulled from a <RowSource> into a database table. Values are
+            loaded as in <write(string, FieldSet&, row_list_t&)>, without a round trip through
+            the text format, and rows are streamed so the source never needs to hold them all.
+
+            Parameters:
+            table  - table name.
+            fields - field names, all table columns if empty.
+            source - row source, each row with a value for every field.
+
+            Returns:
+            rows   - The number of rows written to database.
+        */
+        virtual uint64_t writeRows(std::string table, FieldSet &fields, RowSource &source) = 0;
+
+        /*
+            Function: read(string, FieldSet&, IO*)
+            Bulk export a table or query result into an io object. Rows are streamed in
+            the format that <write(string, FieldSet&, IO*)> accepts: '\t' delimited, '\n'
+            terminated, NULL as \N and backslash escapes in values.
+
+            Parameters:
+            table_or_query - table name, or a query (see <isQuery(string)>).
+            fields         - field names to export from a table, all if empty. Ignored for queries.
+            io             - pointer to an IO object the rows are written to.
+
+            Returns:
+            rows - The number of rows exported.
+        */
+        virtual uint64_t read(std::string table_or_query, FieldSet &fields, IO*) = 0;
+
         /*
             Function: setTimeZoneOffset(int, int)
             Sets the connection timezone offset.
@@ -79,6 +79,22 @@ namespace dbi {
         */
         virtual unsigned char* read(uint32_t r, uint32_t c, uint64_t* len) = 0;
 
+        /*
+            Function: read(uint32_t, uint32_t, Value&)
+            Reads a field at a given position from result in its native representation.
+            Drivers using a binary protocol hand out the decoded value without a round trip
+            through text.
+
+            Parameters:
+            rowno - row number (0 - rows()-1)
+            colno - column number (0 - columns()-1)
+            value - Value passed by reference.
+
+            Returns:
+            true or false - false if the position is out of range, true otherwise.
+        */
+        virtual bool read(uint32_t r, uint32_t c, Value &value) = 0;
+
         /*
             Function: tell
             Returns the current row number in the result set that a subsequent read
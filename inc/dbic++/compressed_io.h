@@ -0,0 +1,116 @@
+#pragma once
+
+#define DBI_CODEC_GZIP 1
+#define DBI_CODEC_ZSTD 2
+
+namespace dbi {
+
+    using namespace std;
+    using namespace pcrecpp;
+
+    /*
+        Class: CompressedIO
+        IO decorator that decompresses data read from another io object, or compresses data
+        written to it. gzip (and zlib) streams need dbic++ built with zlib, zstd streams
+        need it built with libzstd.
+
+        Decompressed data is kept in a small pool of buffers. With a background thread the
+        next buffers are decompressed while the caller, usually <Handle::write(string, FieldSet&, IO*)>,
+        sends the current one to the database.
+
+        Example:
+        (begin code)
+        FileIO file("/tmp/users.tsv.gz", "r");
+        CompressedIO io(&file, "r", DBI_CODEC_GZIP, true);
+
+        FieldSet fields(2, "name", "email");
+        h.write("users", fields, &io);
+
+        // export
+        FileIO out("/tmp/users.tsv.zst", "w");
+        CompressedIO zio(&out, "w", DBI_CODEC_ZSTD);
+        h.read("users", fields, &zio);
+        zio.finish();
+        (end)
+    */
+    class CompressedIO : public IO {
+        protected:
+        struct Buffer {
+            char    *data;
+            uint64_t used, rpos;
+        };
+
+        IO  *io;
+        int  codec, nbuffers;
+        bool writer, threaded, closed;
+        void *stream;
+
+        // end of compressed input, end of the last compressed frame, background thread
+        // done producing and background thread asked to stop.
+        bool eof, ended, finished, stopped;
+        string stringdata, empty, error;
+
+        // compressed input, either a view into io or a copy in input_buffer.
+        const char *input;
+        uint64_t input_len;
+        char *input_buffer;
+
+        // decompressed output or compressed output when writing.
+        Buffer *current, *buffers;
+        deque<Buffer*> filled, idle;
+
+        pthread_t thread;
+        pthread_mutex_t lock;
+        pthread_cond_t  cond;
+
+        bool next();
+        void fill(Buffer *);
+        void decompress(Buffer *);
+        void compress(const char *data, uint64_t len, bool end);
+        void produce();
+        static void* producer(void *);
+
+        public:
+        /*
+            Constructor: CompressedIO(IO*, const char*, int, bool)
+            Parameters:
+            io       - io object holding (or receiving) the compressed data.
+            mode     - "r" to decompress while reading, "w" to compress while writing.
+            codec    - DBI_CODEC_GZIP or DBI_CODEC_ZSTD. gzip also reads zlib streams.
+            threaded - decompress in a background thread, io is only read from that
+                       thread until this object is destroyed.
+        */
+        CompressedIO(IO *io, const char *mode, int codec = DBI_CODEC_GZIP, bool threaded = false);
+
+        /*
+            Destructor: ~CompressedIO
+            Stops the background thread and finishes a compressed stream if <finish> was
+            not called, errors are ignored.
+        */
+        ~CompressedIO();
+
+        string&  read();
+        uint32_t read(char *, uint32_t);
+
+        /*
+            Function: read(const char**, uint64_t)
+            See <IO::read(const char**, uint64_t)>
+        */
+        uint64_t read(const char **, uint64_t);
+
+        void write(const char *);
+        void write(const char *, uint64_t);
+
+        /*
+            Function: finish
+            Ends the compressed stream and writes any buffered data to the io object.
+        */
+        void finish();
+
+        void truncate();
+
+        bool  readline(string &);
+        char* readline();
+    };
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+namespace dbi {
+
+    using namespace std;
+    using namespace pcrecpp;
+
+    /*
+        Class: CopyProgress
+        Counters updated while <copy> runs, they can be read from any thread.
+
+        rows_read    - rows read from the source.
+        rows_written - rows handed to the destination writer.
+        batches      - batches passed from the reader to the writer.
+        reader_waits - times the reader waited on a full queue, the writer is the bottleneck.
+        writer_waits - times the writer waited on an empty queue, the reader is the bottleneck.
+    */
+    struct CopyProgress {
+        uint64_t rows_read, rows_written, batches, reader_waits, writer_waits;
+        CopyProgress() : rows_read(0), rows_written(0), batches(0), reader_waits(0), writer_waits(0) {}
+    };
+
+    /*
+        Function: copy(Handle&, string, param_list_t&, Handle&, string, FieldSet&, CopyProgress*)
+        Streams the result of a query on one handle into a table on another, possibly of a
+        different driver. Rows are read on a separate thread and passed in batches through a
+        bounded queue to <Handle::writeRows(string, FieldSet&, RowSource&)> on the calling
+        thread, so reading and writing overlap and at most a fixed number of rows are held in
+        memory. The reader blocks while the queue is full.
+
+        The source result is read through <Query>, use the streaming settings of the source
+        driver (e.g. unbuffered=1 or cursor=N for mysql, cursor=1 for sqlite3) to keep it from
+        being loaded whole. Neither handle may be used by other threads during the copy.
+
+        Parameters:
+        src      - source handle.
+        sql      - query to read rows from.
+        bind     - bind values for the query.
+        dst      - destination handle.
+        table    - destination table.
+        fields   - destination field names, all table columns if empty.
+        progress - optional counters, updated as the copy runs.
+
+        Returns:
+        Number of rows written. Errors on either side abort the copy and are rethrown, the
+        destination write is rolled back as it would be for a failed writeRows.
+
+        Example:
+        (begin code)
+        Handle pg("pg", getlogin(), "", "dbicpp");
+        Handle cache("sqlite3", "", "", "/tmp/cache.db");
+
+        param_list_t bind;
+        bind.push_back(PARAM("2011-01-01"));
+
+        FieldSet fields(3, "id", "name", "updated_at");
+        dbi::copy(pg, "select id, name, updated_at from users where updated_at > ?", bind, cache, "users", fields);
+        (end)
+    */
+    uint64_t copy(Handle &src, string sql, param_list_t &bind, Handle &dst, string table, FieldSet &fields,
+        CopyProgress *progress = 0);
+}
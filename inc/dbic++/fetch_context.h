@@ -0,0 +1,85 @@
+#pragma once
+
+namespace dbi {
+
+    using namespace std;
+    using namespace pcrecpp;
+
+    /*
+        Class: FetchContext
+        Fetch statistics, phase times and observers of a <Handle> or <Statement>, shared with
+        every <Result> it hands out. Reference counted, so a result can still be read after the
+        handle or statement that produced it is gone. Statement contexts pass fetch times on to
+        their handle's context. Used internally.
+    */
+    class FetchContext {
+        protected:
+        uint32_t refs;
+        FetchContext *parent;
+
+        // created by fetchLatency(), reads are not timed until then.
+        Histogram *latency;
+
+        ~FetchContext();
+
+        // not copyable.
+        FetchContext(const FetchContext&);
+        FetchContext& operator=(const FetchContext&);
+
+        public:
+        // last execution and all timed executions, decode time is added as results are read.
+        PhaseTimes phases, totals;
+
+        // handle owning this context, 0 for statement contexts and once the handle is destroyed.
+        Handle *handle;
+
+        // observers registered with the handle, kept here so results never reach a freed handle.
+        observer_list_t observers;
+
+        FetchContext(FetchContext *parent = 0);
+
+        FetchContext* retain();
+        void release();
+
+        /*
+            Function: fetchLatency
+            Returns:
+            Histogram of row read times, allocated on the first call.
+        */
+        Histogram& fetchLatency();
+
+        /*
+            Function: timed
+            Returns:
+            True if reads need timing, when this or the parent context has a histogram.
+        */
+        bool timed();
+
+        /*
+            Function: source
+            Returns:
+            Handle the context belongs to, directly or through its parent, or 0 if it is gone.
+        */
+        Handle* source();
+
+        /*
+            Function: observed
+            Returns:
+            True if the handle is still around and has observers of its own.
+        */
+        bool observed();
+
+        /*
+            Function: recordFetch(uint64_t)
+            Records the time taken to read a row here and in the parent context, and as decode
+            time when <phaseTiming(bool)> is on.
+        */
+        void recordFetch(uint64_t elapsed);
+
+        /*
+            Function: reset
+            Clears the fetch latency histogram, if there is one, and the phase times.
+        */
+        void reset();
+    };
+}
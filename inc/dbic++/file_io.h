@@ -17,21 +17,21 @@ namespace dbi {
 
         public:
         /*
-            Constructor: FileIO(const char*path, char* mode)
+            Constructor: FileIO(const char*path, const char* mode)
             Initializes an IO object with data from a file.
 
             Parameters:
             path - absolute file path.
-            mode - mode to open file under (currently only "r" makes sense).
+            mode - mode to open file under, "r" to load data or "w" to export data.
         */
-        FileIO(const char *path, char *mode);
+        FileIO(const char *path, const char *mode);
         ~FileIO();
 
         string&  read();
         uint32_t read(char *, uint32_t);
 
         void write(const char *);
-        void write(const char *, uint32_t);
+        void write(const char *, uint64_t);
 
         void truncate();
 
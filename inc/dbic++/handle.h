@@ -44,6 +44,36 @@ namespace dbi {
         protected:
         string_list_t trx;
         AbstractHandle *h;
+        Histogram _latency;
+
+        // fetch latency and phase times, shared with results handed out and outlives the
+        // handle while they are read.
+        FetchContext *_context;
+
+        // statement statistics of the last execute, the fingerprint is reused while the sql repeats.
+        string _sql, _normalized;
+        uint64_t _fingerprint;
+        uint32_t _rows;
+
+        // connection details and threshold for the slow query log, 0 uses the global threshold.
+        string _dbname, _host;
+        uint64_t _slow_threshold;
+
+        // connection made by this handle and not yet closed, for metrics.
+        bool _open;
+
+        void record(string &sql, param_list_t *bind, uint64_t elapsed, uint32_t rows, bool error);
+        void slowQuery(string sql, uint64_t elapsed, uint32_t rows, bool error, uint64_t dropped);
+
+        // per handle observers live in _context, dispatch is skipped unless there are some
+        // there or process wide.
+        inline bool observed() {
+            return _observed || _context->observers.size() > 0;
+        }
+
+        inline bool isSlow(uint64_t elapsed) {
+            return _slow_query_threshold != ~(uint64_t)0 && elapsed >= (_slow_threshold ? _slow_threshold : _slow_query_threshold);
+        }
         public:
         /*
             Constructor: Handle(string, string, string, string, string, string, char*)
@@ -61,11 +91,33 @@ namespace dbi {
 
                   The mysql driver supports the following settings at present,
                     sslca, sslcert, sslkey, sslcapath, sslcipher
+                    unbuffered=1 - stream rows from the server as they are read (mysql_use_result).
+                                   Results can only be read forward, rows() counts the rows read so far
+                                   and the connection stays busy until all rows are read or the result
+                                   is freed.
+                    cursor=N     - prepared statements read rows through a read only server side cursor,
+                                   fetching N rows at a time. Results can only be read forward and rows()
+                                   counts the rows read so far.
 
                   The postgresql driver can be set to use client certificates using the following settings,
                     sslcert, sslkey
-
-                  sqlite3 driver ignores these options currently.
+                  and supports the following driver settings,
+                    binary_results=1 - prepared statements fetch results in binary format when every column
+                                       is of a type the driver can decode (bool, bytea, int2/4/8, oid, float4/8,
+                                       date, time, timestamp, uuid and text types).
+                    binary_params=1  - send bind values in binary format where possible (bool, int2/4/8,
+                                       float4/8, date, timestamp, timestamptz with explicit zone).
+                                       Only prepared statements are affected, they encode values for the
+                                       parameter types picked by the server. Other queries send values as
+                                       text and leave their types to the server.
+
+                  The sqlite3 driver supports the following settings,
+                    cursor=1     - step through rows as they are read instead of loading the whole result.
+                                   Results can only be read forward, rows() counts the rows read so far and
+                                   field pointers are only valid until the next row is read.
+                    write_batch=N - bulk writes commit every N rows, by default a write runs in a single
+                                   transaction. Writes inside a transaction opened by the caller are never
+                                   committed by the driver.
 
 
 
@@ -217,6 +269,24 @@ namespace dbi {
         */
         uint64_t write(std::string table, field_list_t &fields, IO*);
 
+        /*
+            Function: write(string, FieldSet&, row_list_t&)
+            See <AbstractHandle::write(string, FieldSet&, row_list_t&)>
+        */
+        uint64_t write(std::string table, field_list_t &fields, row_list_t &rows);
+
+        /*
+            Function: writeRows(string, FieldSet&, RowSource&)
+            See <AbstractHandle::writeRows(string, FieldSet&, RowSource&)>
+        */
+        uint64_t writeRows(std::string table, field_list_t &fields, RowSource &source);
+
+        /*
+            Function: read(string, FieldSet&, IO*)
+            See <AbstractHandle::read(string, FieldSet&, IO*)>
+        */
+        uint64_t read(std::string table_or_query, field_list_t &fields, IO*);
+
         /*
             Function: setTimeZoneOffset(int, int)
             See <AbstractHandle::setTimeZoneOffset(int, int)>
@@ -247,8 +317,71 @@ namespace dbi {
         */
         void reconnect();
 
+        /*
+            Function: latency
+            Returns:
+            Histogram of the time spent executing queries on this handle, including queries
+            run through statements prepared on it.
+        */
+        Histogram& latency();
+
+        /*
+            Function: fetchLatency
+            Returns:
+            Histogram of the time spent reading each row from results of this handle and statements
+            prepared on it. Reads are timed from the first call on.
+        */
+        Histogram& fetchLatency();
+
+        /*
+            Function: phases
+            Returns:
+            Phase times of the last execute on this handle, decode time grows as its result is read.
+            Empty unless <phaseTiming(bool)> is on.
+        */
+        PhaseTimes& phases();
+
+        /*
+            Function: phaseTotals
+            Returns:
+            Phase times of all timed executes on this handle and statements prepared on it.
+        */
+        PhaseTimes& phaseTotals();
+
+        /*
+            Function: slowQueryThreshold(double)
+            Overrides the <slowQueryLog(double, int)> threshold for queries executed on this handle
+            and statements prepared on it. Queries are logged to the global slow query log sink,
+            nothing is logged unless it is enabled.
+
+            Parameters:
+            threshold - threshold in milliseconds, 0 restores the global threshold.
+        */
+        void slowQueryThreshold(double threshold);
+
+        /*
+            Function: observe(Observer*)
+            Registers an observer for this handle and statements prepared on it, the caller keeps
+            ownership. See <Observer>.
+        */
+        void observe(Observer *observer);
+
+        /*
+            Function: unobserve(Observer*)
+            Unregisters an observer from this handle.
+        */
+        void unobserve(Observer *observer);
+
+        /*
+            Function: observers
+            Returns:
+            Observers registered for this handle.
+        */
+        observer_list_t& observers();
+
         friend class Statement;
         friend class Query;
+        friend class Result;
     };
 }
 
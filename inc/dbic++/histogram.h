@@ -0,0 +1,100 @@
+#pragma once
+
+namespace dbi {
+
+    using namespace std;
+    using namespace pcrecpp;
+
+    /*
+        Class: LatencySnapshot
+        Summary of a <Histogram>, all values in nanoseconds.
+
+        count - number of recorded values.
+        min   - smallest recorded value.
+        max   - largest recorded value.
+        mean  - average of recorded values.
+        p50   - median.
+        p90   - 90th percentile.
+        p99   - 99th percentile.
+        p999  - 99.9th percentile.
+    */
+    struct LatencySnapshot {
+        uint64_t count, min, max, p50, p90, p99, p999;
+        double mean;
+    };
+
+    /*
+        Class: Histogram
+        Latency histogram in the style of HdrHistogram. Values are nanoseconds kept in buckets
+        with a relative error of about 3% from 1ns up to 2^40ns (18 minutes), larger values
+        are counted in the last bucket. Recording is lock free and safe from any thread, the
+        buckets are allocated on the first recorded value.
+
+        Example:
+        (begin code)
+        Handle h("pg", getlogin(), "", "dbicpp");
+        ...
+        LatencySnapshot s = h.latency().snapshot();
+        printf("%lu queries, p99 %.2fms\n", s.count, s.p99 / 1e6);
+        (end)
+    */
+    class Histogram {
+        protected:
+        uint64_t *buckets;
+        uint64_t _count, _sum, _min, _max;
+
+        uint64_t* allocate();
+
+        // not copyable.
+        Histogram(const Histogram&);
+        Histogram& operator=(const Histogram&);
+
+        public:
+        Histogram();
+        ~Histogram();
+
+        /*
+            Function: record(uint64_t)
+            Records a value in nanoseconds.
+        */
+        void record(uint64_t value);
+
+        /*
+            Function: count
+            Returns:
+            Number of recorded values.
+        */
+        uint64_t count();
+
+        /*
+            Function: percentile(double)
+            Parameters:
+            p - percentile between 0 and 100.
+
+            Returns:
+            Value at or below which p percent of the recorded values fall, within the bucket precision.
+        */
+        uint64_t percentile(double p);
+
+        /*
+            Function: snapshot
+            Returns:
+            Count, min, max, mean and common percentiles. Values recorded while the snapshot is
+            taken may be partially included.
+        */
+        LatencySnapshot snapshot();
+
+        /*
+            Function: reset
+            Clears all recorded values. Not safe against concurrent <record> calls.
+        */
+        void reset();
+    };
+
+    /*
+        Function: monotonicTime
+        Returns:
+        Nanoseconds from a monotonic clock, for measuring elapsed time.
+    */
+    uint64_t monotonicTime();
+}
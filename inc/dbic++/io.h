@@ -18,9 +18,28 @@ namespace dbi {
     */
     class IO {
         public:
+        virtual ~IO() {}
+
         virtual string&  read(void) = 0;
         virtual uint32_t read(char *buffer, uint32_t) = 0;
 
+        /*
+            Function: read(const char**, uint64_t)
+            Zero copy read, points data at up to len bytes of the io object's own
+            storage and advances past them. The pointer is valid until the next call
+            that modifies the io object.
+
+            Parameters:
+            data - pointer that is set to the next chunk.
+            len  - maximum number of bytes to return.
+
+            Returns:
+            Number of bytes available at data, 0 when the io object is exhausted or
+            does not support zero copy reads. Callers fall back to read(char*, uint32_t)
+            in the latter case.
+        */
+        virtual uint64_t read(const char **data, uint64_t len) { return 0; }
+
         /*
             Function: write(const char*)
             Appends the given '\0' terminated string to the io object data.
@@ -0,0 +1,84 @@
+#pragma once
+
+#define DBI_METRIC_CONNECTIONS_OPENED 0
+#define DBI_METRIC_CONNECTIONS_CLOSED 1
+#define DBI_METRIC_RECONNECTS         2
+#define DBI_METRIC_QUERIES            3
+#define DBI_METRIC_CONNECTION_ERRORS  4
+#define DBI_METRIC_RUNTIME_ERRORS     5
+#define DBI_METRIC_ROWS_READ          6
+#define DBI_METRIC_BYTES_READ         7
+#define DBI_METRIC_ROWS_WRITTEN       8
+#define DBI_METRIC_ASYNC_IN_FLIGHT    9
+#define DBI_METRICS                   10
+
+namespace dbi {
+
+    using namespace std;
+    using namespace pcrecpp;
+
+    /*
+        Namespace: metrics
+        Process wide client metrics, always collected. Each thread counts into its own block of
+        counters, so updating a metric is a plain add to thread local memory. Blocks are summed
+        when read and folded into the totals when a thread exits.
+
+        DBI_METRIC_CONNECTIONS_OPENED - connections made by <Handle> constructors.
+        DBI_METRIC_CONNECTIONS_CLOSED - connections closed or destroyed.
+        DBI_METRIC_RECONNECTS         - successful reconnects in the drivers.
+        DBI_METRIC_QUERIES            - queries executed, including async and failed ones.
+        DBI_METRIC_CONNECTION_ERRORS  - <ConnectionError> raised by connects and executes.
+        DBI_METRIC_RUNTIME_ERRORS     - other errors raised by connects and executes.
+        DBI_METRIC_ROWS_READ          - rows read from results.
+        DBI_METRIC_BYTES_READ         - size of the values read from results.
+        DBI_METRIC_ROWS_WRITTEN       - rows written by bulk writes.
+        DBI_METRIC_ASYNC_IN_FLIGHT    - gauge, async queries not yet retrieved.
+
+        Example:
+        (begin code)
+        StringIO out;
+        dbi::metrics::prometheus(&out);
+        (end)
+    */
+    namespace metrics {
+
+        /*
+            Function: add(int, int64_t)
+            Adds n to a metric, gauges take negative values.
+        */
+        void add(int metric, int64_t n = 1);
+
+        /*
+            Function: error
+            Counts the exception being handled by its class, call from a catch block only.
+        */
+        void error();
+
+        /*
+            Function: value(int)
+            Returns:
+            Current value of a metric, summed across threads.
+        */
+        int64_t value(int metric);
+
+        /*
+            Function: prometheus
+            Returns:
+            All metrics in the Prometheus text exposition format.
+
+            (begin code)
+            # HELP dbi_queries_total Queries executed.
+            # TYPE dbi_queries_total counter
+            dbi_queries_total 1024
+            ...
+            (end)
+        */
+        string prometheus();
+
+        /*
+            Function: prometheus(IO*)
+            Appends all metrics in the Prometheus text exposition format to an io object.
+        */
+        void prometheus(IO *io);
+    }
+}
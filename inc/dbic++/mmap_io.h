@@ -0,0 +1,60 @@
+#pragma once
+
+namespace dbi {
+
+    using namespace std;
+    using namespace pcrecpp;
+
+    /*
+        Class: MmapIO
+        Read only implementation of IO that maps a file into memory. Reads, readline and zero
+        copy chunk views are served straight from the mapping, which makes it the cheapest way
+        to bulk load large files with <Handle::write(string, FieldSet&, IO*)>.
+
+        Example:
+        (begin code)
+        MmapIO io("/tmp/users.tsv");
+        FieldSet fields(2, "name", "email");
+        h.write("users", fields, &io);
+        (end)
+    */
+    class MmapIO : public IO {
+        protected:
+        char *data;
+        uint64_t size, rpos;
+        string stringdata, empty;
+
+        public:
+        /*
+            Constructor: MmapIO(const char*)
+            Maps a file for sequential reading.
+
+            Parameters:
+            path - file path.
+        */
+        MmapIO(const char *path);
+        ~MmapIO();
+
+        string&  read();
+        uint32_t read(char *, uint32_t);
+
+        /*
+            Function: read(const char**, uint64_t)
+            See <IO::read(const char**, uint64_t)>. Data stays valid for the lifetime of the object.
+        */
+        uint64_t read(const char **, uint64_t);
+
+        /*
+            Function: write(const char*)
+            Not supported, MmapIO is read only.
+        */
+        void write(const char *);
+        void write(const char *, uint64_t);
+
+        void truncate();
+
+        bool  readline(string &);
+        char* readline();
+    };
+
+}
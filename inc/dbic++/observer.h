@@ -0,0 +1,115 @@
+#pragma once
+
+namespace dbi {
+
+    using namespace std;
+    using namespace pcrecpp;
+
+    class Handle;
+    class FetchContext;
+
+    /*
+        Class: Observer
+        Instrumentation hooks, override the callbacks of interest. Observers are registered for
+        the whole process with <addObserver(Observer*)> or for one handle with
+        <Handle::observe(Observer*)>, process wide observers are called first. Nothing is
+        dispatched, timed or counted for observers while none are registered.
+
+        Callbacks run on the thread doing the work and must not throw. The handle is 0 for
+        statements that were not prepared through a <Handle>. Only synchronous executes are
+        reported. Results read after their handle is destroyed report to process wide observers
+        only, with a handle of 0.
+
+        Example:
+        (begin code)
+        class Timer : public dbi::Observer {
+            public:
+            void onExecuteEnd(Handle *h, string &sql, uint32_t rows, uint64_t elapsed, bool error) {
+                printf("%.3fms %s\n", elapsed / 1e6, sql.c_str());
+            }
+        };
+
+        Timer timer;
+        dbi::addObserver(&timer);
+        (end)
+    */
+    class Observer {
+        public:
+        virtual ~Observer() {}
+
+        /*
+            Function: onConnect(Handle*)
+            Called once a handle has connected, only process wide observers see this.
+        */
+        virtual void onConnect(Handle *handle) {}
+
+        /*
+            Function: onReconnect(Handle*)
+            Called after <Handle::reconnect()> succeeds.
+        */
+        virtual void onReconnect(Handle *handle) {}
+
+        /*
+            Function: onExecuteStart(Handle*, string&)
+            Called before a query is sent, sql is as given without bind values.
+        */
+        virtual void onExecuteStart(Handle *handle, string &sql) {}
+
+        /*
+            Function: onExecuteEnd(Handle*, string&, uint32_t, uint64_t, bool)
+            Called after a query finishes or fails.
+
+            Parameters:
+            handle  - handle or 0.
+            sql     - sql without bind values.
+            rows    - rows returned or affected, 0 on error.
+            elapsed - execution time in nanoseconds.
+            error   - true if the query raised an error, which is rethrown after the callback.
+        */
+        virtual void onExecuteEnd(Handle *handle, string &sql, uint32_t rows, uint64_t elapsed, bool error) {}
+
+        /*
+            Function: onBulkWrite(Handle*, string&, uint64_t, uint64_t)
+            Called after <Handle::write> or <Handle::writeRows> loads data into a table.
+
+            Parameters:
+            table - table name.
+            bytes - bytes read from the io object, or the size of the values written.
+            rows  - rows written.
+        */
+        virtual void onBulkWrite(Handle *handle, string &table, uint64_t bytes, uint64_t rows) {}
+
+        /*
+            Function: onResultFetched(Handle*, uint64_t, uint64_t)
+            Called when a result is finished with, once per execution.
+
+            Parameters:
+            handle - handle the result came from, or 0 if it has been destroyed.
+            rows  - rows read.
+            bytes - size of the values read.
+        */
+        virtual void onResultFetched(Handle *handle, uint64_t rows, uint64_t bytes) {}
+    };
+
+    typedef vector<Observer*> observer_list_t;
+
+    /*
+        Function: addObserver(Observer*)
+        Registers a process wide observer, the caller keeps ownership.
+    */
+    void addObserver(Observer *observer);
+
+    /*
+        Function: removeObserver(Observer*)
+        Unregisters a process wide observer.
+    */
+    void removeObserver(Observer *observer);
+
+    // dispatch to process wide observers and those of handle, if any. called by the library.
+    void notifyConnect(Handle *handle);
+    void notifyReconnect(Handle *handle);
+    void notifyExecuteStart(Handle *handle, string &sql);
+    void notifyExecuteEnd(Handle *handle, string &sql, uint32_t rows, uint64_t elapsed, bool error);
+    void notifyBulkWrite(Handle *handle, string &table, uint64_t bytes, uint64_t rows);
+    void notifyResultFetched(FetchContext *context, uint64_t rows, uint64_t bytes);
+}
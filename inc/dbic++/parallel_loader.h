@@ -0,0 +1,123 @@
+#pragma once
+
+namespace dbi {
+
+    using namespace std;
+    using namespace pcrecpp;
+
+    /*
+        Class: ParallelLoader
+        Bulk loads rows over several connections at once. The input io object is split on
+        row boundaries into chunks that are handed to N shards, each shard streams its
+        chunks into the table with <Handle::write(string, FieldSet&, IO*)> on its own
+        connection and thread.
+
+        Rows are not loaded in input order and with transactions enabled each shard
+        commits independently, so a failure can leave some shards loaded.
+
+        Example:
+        (begin code)
+        ParallelLoader loader("pg", getlogin(), "", "dbicpp");
+        loader.shards(8);
+        loader.transactions(true);
+
+        MmapIO io("/tmp/users.tsv");
+        FieldSet fields(2, "name", "email");
+        cout << "Loaded " << loader.write("users", fields, &io) << " rows" << endl;
+        (end)
+    */
+    class ParallelLoader {
+        protected:
+        struct Chunk {
+            string data;
+            uint64_t rpos;
+        };
+
+        class ShardIO;
+
+        struct Shard {
+            ParallelLoader *loader;
+            Handle         *handle;
+            ShardIO        *io;
+            deque<Chunk*>   queue;
+            pthread_t       thread;
+            bool            closed, failed;
+            uint64_t        rows;
+            string          error;
+        };
+
+        string _driver, _user, _pass, _dbname, _host, _port, _options;
+        int _shards;
+        bool _transactions, _aborted;
+        uint64_t _rows;
+        string_list_t _errors;
+
+        // table and fields of the write in progress.
+        string    _table;
+        FieldSet *_fields;
+
+        vector<Shard*>  shards_list;
+        vector<Chunk*>  chunks;
+        deque<Chunk*>   idle;
+        pthread_mutex_t lock;
+        pthread_cond_t  cond;
+
+        Chunk* acquire();
+        bool   dispatch(Chunk *);
+        Chunk* take(Shard *);
+        void   release(Chunk *);
+        void   run(Shard *);
+        void   cleanup();
+        static void* worker(void *);
+
+        public:
+        /*
+            Constructor: ParallelLoader(string, string, string, string, string, string, char*)
+            Takes the same connection arguments as <Handle>, each shard opens its own connection.
+        */
+        ParallelLoader(string driver, string user, string pass, string dbname,
+            string host = "", string port = "", char *options = 0);
+        ~ParallelLoader();
+
+        /*
+            Function: shards(int)
+            Sets the number of connections and threads used, defaults to 4.
+        */
+        void shards(int);
+
+        /*
+            Function: transactions(bool)
+            Wraps each shard in a transaction, a failed shard is rolled back. Off by default.
+        */
+        void transactions(bool);
+
+        /*
+            Function: write(string, FieldSet&, IO*)
+            Loads the rows from the io object in parallel. Rows need to be in the format expected
+            by <Handle::write(string, FieldSet&, IO*)>, one row per '\n' terminated line.
+
+            Parameters:
+            table  - table name.
+            fields - field names.
+            io     - io object to read rows from.
+
+            Returns:
+            Number of rows written, a RuntimeError listing the errors is thrown if any shard failed.
+        */
+        uint64_t write(string table, FieldSet &fields, IO *io);
+
+        /*
+            Function: rows
+            Returns:
+            Number of rows written by shards that succeeded in the last <write>.
+        */
+        uint64_t rows();
+
+        /*
+            Function: errors
+            Returns:
+            Errors of the shards that failed in the last <write>, prefixed with the shard number.
+        */
+        string_list_t& errors();
+    };
+}
@@ -16,13 +16,18 @@ namespace dbi {
             bool   isnull;
             string value;
             bool   binary;
+            int    type;
         };
         (end)
+
+        type is one of the DBI_TYPE_* constants or DBI_TYPE_UNKNOWN (0) when the value is untyped text.
+        Drivers that bind parameters in binary format use it to pick the wire type.
     */
     struct Param {
         bool   isnull;
         string value;
         bool   binary;
+        int    type;
     };
 
     /*
@@ -55,6 +60,11 @@ namespace dbi {
         Creates a Param given binary data.
     */
     Param PARAM_BINARY(unsigned char* data, uint64_t l);
+    /*
+        Function: PARAM_TYPED(const char*, int)
+        Creates a Param given a string representation of a value of the given DBI_TYPE_*.
+    */
+    Param PARAM_TYPED(const char* s, int type);
 
     std::ostream& operator<<(std::ostream &out, Param &p);
 }
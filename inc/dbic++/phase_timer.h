@@ -0,0 +1,97 @@
+#pragma once
+
+#define DBI_PHASE_PREPROCESS 0
+#define DBI_PHASE_BIND       1
+#define DBI_PHASE_SEND       2
+#define DBI_PHASE_WAIT       3
+#define DBI_PHASE_FETCH      4
+#define DBI_PHASE_DECODE     5
+#define DBI_PHASES           6
+
+namespace dbi {
+
+    using namespace std;
+    using namespace pcrecpp;
+
+    /*
+        Class: PhaseTimes
+        Time spent in each phase of executing a query, in nanoseconds. Indexed by phase,
+
+        DBI_PHASE_PREPROCESS - rewriting the sql or preparing it (sqlite3 handle executes).
+        DBI_PHASE_BIND       - encoding bind values or interpolating them into the sql.
+        DBI_PHASE_SEND       - writing the query to the server.
+        DBI_PHASE_WAIT       - waiting for the server to respond, the whole execution for sqlite3
+                               and mysql prepared statements which send and wait in one call.
+        DBI_PHASE_FETCH      - receiving and buffering the result.
+        DBI_PHASE_DECODE     - materializing rows in <Result::read>.
+
+        executions - number of executions included.
+    */
+    struct PhaseTimes {
+        uint64_t executions;
+        uint64_t time[DBI_PHASES];
+
+        PhaseTimes();
+        void reset();
+    };
+
+    /*
+        Function: phaseTiming(bool)
+        Turns per phase timing of synchronous executes on or off, off by default. Timing adds a
+        few clock reads per execution and one per row read, the pg driver also waits on the
+        socket itself to tell server wait apart from receiving the result.
+
+        Example:
+        (begin code)
+        dbi::phaseTiming(true);
+        h.execute("select * from users");
+        PhaseTimes &p = h.phases();
+        for (int n = 0; n < DBI_PHASES; n++)
+            printf("%-10s %.3fms\n", dbi::phaseName(n), p.time[n] / 1e6);
+        (end)
+    */
+    void phaseTiming(bool flag);
+
+    /*
+        Function: phaseName(int)
+        Returns:
+        Name of a phase, e.g. "preprocess" or "wait".
+    */
+    const char* phaseName(int phase);
+
+    /*
+        Function: phaseTotals
+        Returns:
+        Phase times of all timed executions in the process.
+    */
+    PhaseTimes phaseTotals();
+
+    /*
+        Function: resetPhaseTotals
+        Clears the process wide phase times.
+    */
+    void resetPhaseTotals();
+
+    /*
+        Function: phaseClock
+        Returns:
+        Nanoseconds from CLOCK_MONOTONIC_RAW, which is not slewed by ntp.
+    */
+    uint64_t phaseClock();
+
+    // execution bracket used by Handle and Statement, the current execution is per thread.
+    // last is cleared and receives this execution, totals accumulate across executions.
+    void phaseBegin(PhaseTimes *last, PhaseTimes *totals, PhaseTimes *parent = 0);
+    void phaseEnd();
+    void phaseAdd(PhaseTimes **times, int phase, uint64_t elapsed);
+    void phaseMark(int phase);
+
+    /*
+        Function: phaseLap(int)
+        Called by drivers when a phase ends, the time since the previous lap or the start of the
+        execution is added to the phase.
+    */
+    inline void phaseLap(int phase) {
+        if (_phase_timing) phaseMark(phase);
+    }
+}
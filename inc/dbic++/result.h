@@ -12,6 +12,22 @@ namespace dbi {
         protected:
         AbstractResult *rs;
 
+        // fetch statistics, phase times and observers of the handle or statement the result
+        // came from, held until destroyed.
+        FetchContext *context;
+        void attach(FetchContext *context);
+        void recordFetch(uint64_t elapsed);
+
+        // async query counted in the in flight gauge until retrieved.
+        bool in_flight;
+        void inFlight();
+        void landed();
+
+        // statement statistics, rows and bytes read are added to the fingerprint when done.
+        uint64_t fingerprint, fetched_rows, fetched_bytes, counted_rows;
+        void track(uint64_t fingerprint, uint64_t rows);
+        void flushStats();
+
         public:
         Result();
         /*
@@ -67,6 +83,12 @@ namespace dbi {
         */
         unsigned char* read(uint32_t r, uint32_t c, uint64_t*);
 
+        /*
+            Function: read(uint32_t, uint32_t, Value&)
+            See <AbstractResult::read(uint32_t, uint32_t, Value&)>
+        */
+        bool read(uint32_t r, uint32_t c, Value&);
+
         /*
             Operator: (uint32_t, uint32_t)
             Alias for read(uint32_t, uint32_t)
@@ -105,5 +127,8 @@ namespace dbi {
 
         // async
         void retrieve();
+
+        friend class Handle;
+        friend class Statement;
     };
 }
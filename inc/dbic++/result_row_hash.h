@@ -21,6 +21,14 @@ namespace dbi {
             fields - string_list_t
         */
         string_list_t fields();
+        /*
+            Function: bytes
+            Returns the total length of the values in the row.
+
+            Returns:
+            bytes - uint64_t
+        */
+        uint64_t bytes();
         operator bool() { return data.size() > 0; }
         /*
             Operator: [](const char*)
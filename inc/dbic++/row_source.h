@@ -0,0 +1,66 @@
+#pragma once
+
+namespace dbi {
+
+    using namespace std;
+    using namespace pcrecpp;
+
+    /*
+        Class: RowSource
+        Pull interface for <Handle::writeRows(string, FieldSet&, RowSource&)>. Rows are
+        requested one at a time, so a source can generate or convert rows on the fly
+        without materializing the whole data set.
+
+        Example:
+        (begin code)
+        class Numbers : public RowSource {
+            int n;
+            char id[32];
+            ResultRow row;
+
+            public:
+            Numbers() : n(0) { row.resize(1); }
+            ResultRow* next() {
+                if (n == 1000) return 0;
+                snprintf(id, 32, "%d", n++);
+                row[0] = PARAM(id);
+                return &row;
+            }
+        };
+
+        Numbers source;
+        FieldSet fields(1, "id");
+        h.writeRows("numbers", fields, source);
+        (end)
+    */
+    class RowSource {
+        public:
+        virtual ~RowSource() {}
+
+        /*
+            Function: next
+            Returns the next row, or 0 when there are no more rows. The row only needs to stay
+            valid until the following call to next.
+        */
+        virtual ResultRow* next() = 0;
+    };
+
+    /*
+        Class: RowList
+        <RowSource> over an in memory list of rows.
+    */
+    class RowList : public RowSource {
+        protected:
+        row_list_t &list;
+        uint64_t position;
+
+        public:
+        /*
+            Constructor: RowList(row_list_t&)
+            Parameters:
+            rows - rows to hand out, the list is not copied.
+        */
+        RowList(row_list_t &rows);
+        ResultRow* next();
+    };
+}
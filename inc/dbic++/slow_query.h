@@ -0,0 +1,84 @@
+#pragma once
+
+namespace dbi {
+
+    using namespace std;
+    using namespace pcrecpp;
+
+    /*
+        Class: SlowQuery
+        A query that took longer than the slow query threshold.
+
+        sql     - sql with bind values, formatted as in trace output.
+        rows    - rows returned or affected, 0 if the query failed.
+        elapsed - execution time in nanoseconds.
+        error   - true if the query raised an error.
+        driver  - driver name.
+        dbname  - database name, empty if unknown.
+        host    - host name, empty if unknown or local.
+    */
+    struct SlowQuery {
+        string sql;
+        uint32_t rows;
+        uint64_t elapsed;
+        bool error;
+        string driver, dbname, host;
+    };
+
+    typedef void (*slow_query_callback_t)(SlowQuery &query, void *data);
+
+    /*
+        Function: slowQueryLog(double, int)
+        Logs queries executed through <Handle>, <Statement> and <Query> that take at least
+        threshold milliseconds to a file descriptor, in the same format as trace output.
+        Queries under the threshold cost a single comparison, so the log can stay enabled.
+
+        Parameters:
+        threshold - threshold in milliseconds.
+        fd        - file descriptor.
+
+        Example:
+        (begin code)
+        dbi::slowQueryLog(250, 2);
+        dbi::slowQueryRateLimit(5);
+        (end)
+    */
+    void slowQueryLog(double threshold, int fd);
+
+    /*
+        Function: slowQueryLog(double, IO*)
+        Same as <slowQueryLog(double, int)>, appending one line per query to an io object.
+        Writes to the io object are serialized.
+    */
+    void slowQueryLog(double threshold, IO *io);
+
+    /*
+        Function: slowQueryLog(double, slow_query_callback_t, void*)
+        Same as <slowQueryLog(double, int)>, calling a function with each slow query. Calls
+        are not serialized, the callback may run on several threads at once.
+
+        Parameters:
+        threshold - threshold in milliseconds.
+        callback  - void callback(SlowQuery &query, void *data)
+        data      - passed to the callback as is.
+    */
+    void slowQueryLog(double threshold, slow_query_callback_t callback, void *data = 0);
+
+    /*
+        Function: slowQueryLogOff
+        Turns off the slow query log.
+    */
+    void slowQueryLogOff();
+
+    /*
+        Function: slowQueryRateLimit(uint32_t)
+        Logs at most n slow queries per second, defaults to 10. Queries over the limit are
+        dropped and counted, the count is added to the next logged line. 0 removes the limit.
+    */
+    void slowQueryRateLimit(uint32_t n);
+
+    // called by Handle and Statement once a query is over the threshold, the rate limit is
+    // checked first so dropped queries are never formatted. dropped is the count to report.
+    bool admitSlowQuery(uint64_t &dropped);
+    void logSlowQuery(SlowQuery &query, uint64_t dropped);
+}
@@ -17,6 +17,26 @@ namespace dbi {
         AbstractStatement *st;
         param_list_t params;
 
+        // handle the statement was prepared on, if known, for per handle latencies.
+        Handle *handle;
+
+        // created on first use, see latency() and fetchContext().
+        Histogram *_latency;
+        FetchContext *_context;
+
+        FetchContext* fetchContext();
+        void resetTimes();
+
+        // normalized sql and fingerprint for statement statistics, computed on first use.
+        string _normalized;
+        uint64_t _fingerprint;
+
+        void record(uint64_t elapsed, uint32_t rows, param_list_t &bind, bool error);
+
+        inline bool observed() {
+            return _observed || (handle && handle->observed());
+        }
+
         public:
         Statement();
         /*
@@ -223,6 +243,9 @@ namespace dbi {
             Returns a pointer to a result object. This needs to be
             deallocated explicitly.
 
+            mysql results read the rows held by the statement rather than a copy, they find no
+            more rows once the statement is executed again but outlive the statement itself.
+
             Returns:
             Result* - Pointer to the Result set object.
         */
@@ -241,5 +264,34 @@ namespace dbi {
         */
         uint64_t lastInsertID();
 
+        /*
+            Function: latency
+            Returns:
+            Histogram of the time spent executing this statement. Executions are timed from the
+            first call on.
+        */
+        Histogram& latency();
+
+        /*
+            Function: fetchLatency
+            Returns:
+            Histogram of the time spent reading each row from results of this statement. Reads
+            are timed from the first call on.
+        */
+        Histogram& fetchLatency();
+
+        /*
+            Function: phases
+            Returns:
+            Phase times of the last execution of this statement, see <Handle::phases()>.
+        */
+        PhaseTimes& phases();
+
+        /*
+            Function: phaseTotals
+            Returns:
+            Phase times of all timed executions of this statement.
+        */
+        PhaseTimes& phaseTotals();
     };
 }
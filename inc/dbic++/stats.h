@@ -0,0 +1,114 @@
+#pragma once
+
+namespace dbi {
+
+    using namespace std;
+    using namespace pcrecpp;
+
+    /*
+        Namespace: stats
+        Client side statement statistics, similar to pg_stat_statements. Queries executed through
+        <Handle>, <Statement> and <Query> are normalized into a fingerprint and calls, time, rows
+        and bytes are accumulated per fingerprint, across all handles and drivers in the process.
+
+        Collection is off by default.
+
+        Example:
+        (begin code)
+        dbi::stats::enable(true);
+        ...
+        stats::entry_list_t top = dbi::stats::top(10);
+        for (int n = 0; n < top.size(); n++)
+            printf("%8lu calls %10.3fms %s\n", top[n].calls, top[n].total_time / 1e6, top[n].sql.c_str());
+        (end)
+    */
+    namespace stats {
+
+        /*
+            Class: Entry
+            Statistics of one statement fingerprint.
+
+            fingerprint - hash of the normalized sql.
+            sql         - normalized sql.
+            calls       - number of executions.
+            errors      - number of executions that raised an error.
+            total_time  - total execution time in nanoseconds.
+            max_time    - longest execution in nanoseconds.
+            rows        - rows returned or affected.
+            bytes       - bytes sent (sql and bind values) and received (values read from results).
+        */
+        struct Entry {
+            uint64_t fingerprint;
+            string sql;
+            uint64_t calls, errors, total_time, max_time, rows, bytes;
+        };
+
+        typedef vector<Entry> entry_list_t;
+
+        /*
+            Function: enable(bool)
+            Turns statistics collection on or off.
+        */
+        void enable(bool flag);
+
+        /*
+            Function: enabled
+            Returns:
+            true if statistics are being collected.
+        */
+        bool enabled();
+
+        /*
+            Function: normalize(string)
+            Normalizes sql for fingerprinting. Literals and placeholders are replaced with ?,
+            comma separated lists of them collapse to a single ?, comments are dropped,
+            whitespace is collapsed and unquoted text is lower cased.
+
+            Returns:
+            normalized sql, e.g. "SELECT * FROM users WHERE id IN (1, 2, 3) AND name = 'x'"
+            becomes "select * from users where id in (?) and name = ?".
+        */
+        string normalize(string sql);
+
+        /*
+            Function: fingerprint(string)
+            Returns:
+            64 bit hash of normalized sql.
+        */
+        uint64_t fingerprint(string normalized);
+
+        /*
+            Function: record(uint64_t, string&, uint64_t, uint64_t, uint64_t, bool)
+            Accumulates one execution, this is called by the library.
+
+            Parameters:
+            fingerprint - fingerprint of the normalized sql.
+            normalized  - normalized sql, stored the first time a fingerprint is seen.
+            elapsed     - execution time in nanoseconds.
+            rows        - rows returned or affected.
+            bytes       - bytes transferred.
+            error       - true if the execution failed.
+        */
+        void record(uint64_t fingerprint, string &normalized, uint64_t elapsed, uint64_t rows, uint64_t bytes,
+            bool error = false);
+
+        /*
+            Function: fetched(uint64_t, uint64_t, uint64_t)
+            Adds rows and bytes read from a result to an existing fingerprint.
+        */
+        void fetched(uint64_t fingerprint, uint64_t rows, uint64_t bytes);
+
+        /*
+            Function: top(int)
+            Returns:
+            Up to n entries with the highest total execution time, in descending order.
+        */
+        entry_list_t top(int n);
+
+        /*
+            Function: reset
+            Discards all collected statistics.
+        */
+        void reset();
+    }
+}
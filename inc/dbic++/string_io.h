@@ -11,6 +11,11 @@ namespace dbi {
         you just want to insert data into a table (or fetch data from a table) without
         the overhead of multiple statement execution.
 
+        Data is buffered in a chain of chunks, so writes never move data already written
+        and chunks are freed as they are read. Bulk loaders consume the chunks in place
+        through <read(const char**, uint64_t)> or <readv(struct iovec*, int)>.
+        A StringIO is not synchronized, use one per thread.
+
 
         Example:
         (begin code)
@@ -51,9 +56,22 @@ namespace dbi {
     */
     class StringIO : public IO {
         protected:
+        // data is kept in a chain of chunks from head to tail, chunks before current have
+        // been read and are released on the next call.
+        struct Chunk {
+            Chunk   *next;
+            uint64_t size, used;
+            char     data[1];
+        };
+
         string stringdata, empty;
-        unsigned char* data;
-        uint64_t alloc, wpos, rpos;
+        Chunk *head, *tail, *current, *spare;
+        uint64_t rpos, chunk_size;
+
+        void   init();
+        Chunk* allocate(uint64_t size);
+        void   release();
+        char*  reserve(uint64_t size);
 
         public:
         /*
@@ -95,6 +113,33 @@ namespace dbi {
         string&  read(void);
         uint32_t read(char *buffer, uint32_t);
 
+        /*
+            Function: read(const char**, uint64_t)
+            See <IO::read(const char**, uint64_t)>
+        */
+        uint64_t read(const char **data, uint64_t len);
+
+        /*
+            Function: readv(struct iovec*, int)
+            Zero copy read of up to count chunks, the iovecs point into the buffer and stay
+            valid until the next call that modifies the io object.
+
+            Parameters:
+            iov   - iovec array to fill.
+            count - size of iovec array.
+
+            Returns:
+            Number of iovecs filled, 0 when there is no data left to read.
+        */
+        int readv(struct iovec *iov, int count);
+
+        /*
+            Function: length
+            Returns:
+            Number of bytes written and not yet read.
+        */
+        uint64_t length();
+
         bool  readline(string &);
         char* readline();
     };
@@ -0,0 +1,104 @@
+#pragma once
+
+namespace dbi {
+
+    using namespace std;
+    using namespace pcrecpp;
+
+    /*
+        Function: escapeTsv(string&, const char*, uint64_t)
+        Appends a field value to a tab separated row, escaping backslash, tab, newline,
+        carriage return and NUL the way PostgreSQL COPY and MySQL LOAD DATA expect.
+
+        Parameters:
+        out    - row being built.
+        data   - field value.
+        length - length of field value.
+    */
+    void escapeTsv(string &out, const char *data, uint64_t length);
+
+    /*
+        Class: TsvWriter
+        Encodes rows into the tab separated text format accepted by
+        <Handle::write(string, FieldSet&, IO*)>, on both PostgreSQL (COPY) and MySQL
+        (LOAD DATA). NULL values are written as \N and values are escaped as needed.
+        Rows are buffered and appended to the io object in large writes.
+
+        Example:
+        (begin code)
+        StringIO buffer;
+        TsvWriter tsv(&buffer);
+
+        tsv.write(PARAM("sally"));
+        tsv.write(PARAM("line 1\nline 2"));
+        tsv.end();
+        tsv.flush();
+
+        FieldSet fields(2, "name", "notes");
+        h.write("users", fields, &buffer);
+        (end)
+    */
+    class TsvWriter {
+        protected:
+        IO *io;
+        string buffer;
+        uint64_t nrows;
+        int column;
+        bool hex;
+
+        void separate();
+
+        public:
+        /*
+            Constructor: TsvWriter(IO*, bool)
+            Parameters:
+            io  - io object the rows are appended to.
+            hex - write binary params as \\x hex, the PostgreSQL bytea input format. Pass false
+                  for MySQL LOAD DATA, which takes the escaped bytes as is.
+        */
+        TsvWriter(IO *io, bool hex = true);
+
+        /*
+            Destructor: ~TsvWriter
+            Flushes any buffered rows, errors are ignored. Call <flush> to handle them.
+        */
+        ~TsvWriter();
+
+        /*
+            Function: write(Param&)
+            Appends a field to the current row.
+        */
+        void write(Param &);
+
+        /*
+            Function: write(const char*, uint64_t)
+            Appends a field to the current row, a null pointer is written as NULL.
+        */
+        void write(const char *, uint64_t);
+
+        /*
+            Function: write(ResultRow&)
+            Appends all fields of a row and ends the row.
+        */
+        void write(ResultRow &);
+
+        /*
+            Function: end
+            Ends the current row.
+        */
+        void end();
+
+        /*
+            Function: flush
+            Appends buffered rows to the io object.
+        */
+        void flush();
+
+        /*
+            Function: rows
+            Returns:
+            Number of rows ended so far.
+        */
+        uint64_t rows();
+    };
+}
@@ -45,4 +45,16 @@ namespace dbi {
     string formatParams(string sql, param_list_t &p);
 
     string generateCompactUUID();
+
+    /*
+        Function: isQuery(string)
+        Tells a query (select, with, values, table ...) apart from a table name.
+
+        Parameters:
+        sql - table name or sql.
+
+        Returns:
+        true if the string is a query.
+    */
+    bool isQuery(string sql);
 }
@@ -0,0 +1,91 @@
+#pragma once
+
+namespace dbi {
+
+    /*
+        Struct: Timestamp
+        Broken down date, time or timestamp value.
+
+        (begin code)
+        struct Timestamp {
+            int year, month, day;
+            int hour, minute, second, usec;
+            int tzoffset;
+        };
+        (end)
+
+        tzoffset is the offset from UTC in seconds, 0 when the value carries no time zone.
+    */
+    struct Timestamp {
+        int year, month, day;
+        int hour, minute, second, usec;
+        int tzoffset;
+    };
+
+    /*
+        Struct: Value
+        A field value in its native representation, see <AbstractResult::read(uint32_t, uint32_t, Value&)>.
+
+        (begin code)
+        struct Value {
+            int  type;
+            bool isnull;
+            union {
+                int64_t   i;
+                double    f;
+                Timestamp t;
+            };
+            unsigned char *data;
+            uint64_t       length;
+        };
+        (end)
+
+        type is one of the DBI_TYPE_* constants and decides which member holds the value,
+
+            - DBI_TYPE_INT, DBI_TYPE_BOOLEAN              - i
+            - DBI_TYPE_FLOAT                              - f
+            - DBI_TYPE_TIME, DBI_TYPE_DATE, DBI_TYPE_TIMESTAMP - t
+            - DBI_TYPE_TEXT, DBI_TYPE_BLOB, DBI_TYPE_NUMERIC - data and length
+
+        data and length always point to the raw field when the driver has it at hand and follow
+        the same lifetime rules as <AbstractResult::read(uint32_t, uint32_t, uint64_t*)>.
+    */
+    struct Value {
+        int  type;
+        bool isnull;
+        union {
+            int64_t   i;
+            double    f;
+            Timestamp t;
+        };
+        unsigned char *data;
+        uint64_t       length;
+    };
+
+    /*
+        Function: parseValue(int, unsigned char*, uint64_t, Value&)
+        Converts a field in text format to its native value. Drivers that only get text back
+        from the server use this to implement <AbstractResult::read(uint32_t, uint32_t, Value&)>.
+
+        Parameters:
+        type   - DBI_TYPE_* constant.
+        data   - field data or NULL for a NULL value.
+        length - field length.
+        value  - Value passed by reference.
+    */
+    void parseValue(int type, unsigned char *data, uint64_t length, Value &value);
+
+    /*
+        Function: formatValue(Value&, char*, size_t)
+        Formats a native value as text, the inverse of parseValue().
+
+        Parameters:
+        value  - Value.
+        buffer - output buffer.
+        size   - size of output buffer.
+
+        Returns:
+        length - characters written, excluding the terminating '\0'.
+    */
+    int formatValue(Value &value, char *buffer, size_t size);
+}
@@ -0,0 +1,62 @@
+# - Try to find zstd
+# Once done this will define
+#
+#  ZSTD_FOUND - system has zstd
+#  ZSTD_INCLUDE_DIRS - the zstd include directory
+#  ZSTD_LIBRARIES - Link these to use zstd
+#
+#  Redistribution and use is allowed according to the terms of the New
+#  BSD license.
+#  For details see the accompanying COPYING-CMAKE-SCRIPTS file.
+#
+
+
+if (ZSTD_LIBRARIES AND ZSTD_INCLUDE_DIRS)
+  # in cache already
+  set(ZSTD_FOUND TRUE)
+else (ZSTD_LIBRARIES AND ZSTD_INCLUDE_DIRS)
+  find_path(ZSTD_INCLUDE_DIR
+    NAMES
+      zstd.h
+    PATHS
+      /usr/include
+      /usr/local/include
+      /opt/local/include
+      /sw/include
+  )
+
+  find_library(ZSTD_LIBRARY
+    NAMES
+      zstd
+    PATHS
+      /usr/lib
+      /usr/local/lib
+      /opt/local/lib
+      /sw/lib
+  )
+
+  set(ZSTD_INCLUDE_DIRS
+    ${ZSTD_INCLUDE_DIR}
+  )
+  set(ZSTD_LIBRARIES
+    ${ZSTD_LIBRARY}
+  )
+
+  if (ZSTD_INCLUDE_DIRS AND ZSTD_LIBRARIES)
+     set(ZSTD_FOUND TRUE)
+  endif (ZSTD_INCLUDE_DIRS AND ZSTD_LIBRARIES)
+
+  if (ZSTD_FOUND)
+    if (NOT zstd_FIND_QUIETLY)
+      message(STATUS "Found zstd: ${ZSTD_LIBRARIES}")
+    endif (NOT zstd_FIND_QUIETLY)
+  else (ZSTD_FOUND)
+    if (zstd_FIND_REQUIRED)
+      message(FATAL_ERROR "Could not find zstd")
+    endif (zstd_FIND_REQUIRED)
+  endif (ZSTD_FOUND)
+
+  # show the ZSTD_INCLUDE_DIRS and ZSTD_LIBRARIES variables only in the advanced view
+  mark_as_advanced(ZSTD_INCLUDE_DIRS ZSTD_LIBRARIES)
+
+endif (ZSTD_LIBRARIES AND ZSTD_INCLUDE_DIRS)
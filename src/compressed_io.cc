@@ -0,0 +1,437 @@
+#include "dbic++.h"
+
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HAS_ZSTD
+#include <zstd.h>
+#endif
+
+// size of each buffer and number of buffers decompressed ahead by the background thread.
+#define COMPRESSED_IO_BUFFER 1048576
+#define COMPRESSED_IO_POOL   4
+
+namespace dbi {
+    CompressedIO::CompressedIO(IO *io, const char *mode, int codec, bool threaded) {
+        this->io       = io;
+        this->codec    = codec;
+        this->writer   = mode && mode[0] == 'w';
+        this->threaded = threaded && !writer;
+
+        closed       = false;
+        eof          = false;
+        ended        = true;
+        finished     = false;
+        stopped      = false;
+        stream       = 0;
+        input        = 0;
+        input_len    = 0;
+        input_buffer = 0;
+        current      = 0;
+
+        switch (codec) {
+#ifdef HAS_ZLIB
+            case DBI_CODEC_GZIP: {
+                z_stream *z = (z_stream*)calloc(1, sizeof(z_stream));
+                if (!z) throw RuntimeError("Out of memory: CompressedIO");
+                // 15 + 16 writes a gzip header, 15 + 32 reads either gzip or zlib.
+                int rc = writer ? deflateInit2(z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY)
+                                : inflateInit2(z, 15 + 32);
+                if (rc != Z_OK) {
+                    free(z);
+                    throw RuntimeError("CompressedIO: unable to initialize zlib stream");
+                }
+                stream = z;
+                break;
+            }
+#endif
+#ifdef HAS_ZSTD
+            case DBI_CODEC_ZSTD:
+                if (writer) {
+                    ZSTD_CStream *zs = ZSTD_createCStream();
+                    if (!zs || ZSTD_isError(ZSTD_initCStream(zs, 3))) {
+                        ZSTD_freeCStream(zs);
+                        throw RuntimeError("CompressedIO: unable to initialize zstd stream");
+                    }
+                    stream = zs;
+                }
+                else {
+                    ZSTD_DStream *zs = ZSTD_createDStream();
+                    if (!zs || ZSTD_isError(ZSTD_initDStream(zs))) {
+                        ZSTD_freeDStream(zs);
+                        throw RuntimeError("CompressedIO: unable to initialize zstd stream");
+                    }
+                    stream = zs;
+                }
+                break;
+#endif
+            default:
+                throw RuntimeError("CompressedIO: codec is not supported by this build of dbic++");
+        }
+
+        nbuffers = this->threaded ? COMPRESSED_IO_POOL : 1;
+        buffers  = new Buffer[nbuffers];
+        for (int n = 0; n < nbuffers; n++) {
+            buffers[n].data = new char[COMPRESSED_IO_BUFFER];
+            buffers[n].used = buffers[n].rpos = 0;
+            idle.push_back(&buffers[n]);
+        }
+
+        if (writer)
+            current = &buffers[0];
+
+        if (this->threaded) {
+            pthread_mutex_init(&lock, 0);
+            pthread_cond_init(&cond, 0);
+            // fall back to decompressing as data is read.
+            if (pthread_create(&thread, 0, producer, this) != 0) {
+                pthread_mutex_destroy(&lock);
+                pthread_cond_destroy(&cond);
+                this->threaded = false;
+            }
+        }
+    }
+
+    CompressedIO::~CompressedIO() {
+        if (writer && !closed) {
+            try {
+                finish();
+            }
+            catch (...) {
+            }
+        }
+
+        if (threaded) {
+            pthread_mutex_lock(&lock);
+            stopped = true;
+            pthread_cond_broadcast(&cond);
+            pthread_mutex_unlock(&lock);
+
+            pthread_join(thread, 0);
+            pthread_mutex_destroy(&lock);
+            pthread_cond_destroy(&cond);
+        }
+
+        switch (codec) {
+#ifdef HAS_ZLIB
+            case DBI_CODEC_GZIP:
+                if (writer) deflateEnd((z_stream*)stream);
+                else        inflateEnd((z_stream*)stream);
+                free(stream);
+                break;
+#endif
+#ifdef HAS_ZSTD
+            case DBI_CODEC_ZSTD:
+                if (writer) ZSTD_freeCStream((ZSTD_CStream*)stream);
+                else        ZSTD_freeDStream((ZSTD_DStream*)stream);
+                break;
+#endif
+        }
+
+        for (int n = 0; n < nbuffers; n++)
+            delete [] buffers[n].data;
+        delete [] buffers;
+        delete [] input_buffer;
+    }
+
+    // decompresses as much of the pending input as fits into the buffer.
+    void CompressedIO::decompress(Buffer *b) {
+        switch (codec) {
+#ifdef HAS_ZLIB
+            case DBI_CODEC_GZIP: {
+                uint64_t before = b->used;
+                z_stream *z  = (z_stream*)stream;
+                z->next_in   = (Bytef*)input;
+                z->avail_in  = input_len;
+                z->next_out  = (Bytef*)b->data + b->used;
+                z->avail_out = COMPRESSED_IO_BUFFER - b->used;
+
+                int rc = inflate(z, Z_NO_FLUSH);
+                if (rc != Z_OK && rc != Z_STREAM_END && rc != Z_BUF_ERROR)
+                    throw RuntimeError(z->msg ? z->msg : "CompressedIO: invalid gzip data");
+
+                bool progress = z->avail_in < input_len || z->avail_out < COMPRESSED_IO_BUFFER - before;
+                input    += input_len - z->avail_in;
+                input_len = z->avail_in;
+                b->used   = COMPRESSED_IO_BUFFER - z->avail_out;
+
+                // concatenated gzip members are read as one stream.
+                if (rc == Z_STREAM_END) {
+                    ended = true;
+                    inflateReset(z);
+                }
+                else if (progress)
+                    ended = false;
+                break;
+            }
+#endif
+#ifdef HAS_ZSTD
+            case DBI_CODEC_ZSTD: {
+                uint64_t before = b->used;
+                ZSTD_inBuffer  in  = {input, input_len, 0};
+                ZSTD_outBuffer out = {b->data, COMPRESSED_IO_BUFFER, b->used};
+
+                size_t rc = ZSTD_decompressStream((ZSTD_DStream*)stream, &out, &in);
+                if (ZSTD_isError(rc))
+                    throw RuntimeError(ZSTD_getErrorName(rc));
+
+                input     += in.pos;
+                input_len -= in.pos;
+                b->used    = out.pos;
+
+                // 0 means the frame is complete and fully flushed.
+                if (in.pos > 0 || out.pos > before)
+                    ended = rc == 0;
+                break;
+            }
+#endif
+        }
+    }
+
+    // fills a buffer with decompressed data, a partially filled buffer means end of data.
+    void CompressedIO::fill(Buffer *b) {
+        b->used = b->rpos = 0;
+
+        while (b->used < COMPRESSED_IO_BUFFER) {
+            if (input_len == 0 && !eof) {
+                const char *chunk;
+                uint64_t len = io->read(&chunk, COMPRESSED_IO_BUFFER);
+                if (len == 0) {
+                    if (!input_buffer) input_buffer = new char[COMPRESSED_IO_BUFFER];
+                    len   = io->read(input_buffer, COMPRESSED_IO_BUFFER);
+                    chunk = input_buffer;
+                }
+                input     = chunk;
+                input_len = len;
+                eof       = len == 0;
+            }
+
+            uint64_t before = b->used, pending = input_len;
+            decompress(b);
+
+            if (eof && input_len == pending && b->used == before) {
+                if (!ended)
+                    throw RuntimeError("CompressedIO: unexpected end of compressed data");
+                break;
+            }
+        }
+    }
+
+    void* CompressedIO::producer(void *arg) {
+        ((CompressedIO*)arg)->produce();
+        return 0;
+    }
+
+    // background thread, decompresses into free buffers until the input is exhausted.
+    void CompressedIO::produce() {
+        while (true) {
+            Buffer *b;
+            string message;
+
+            pthread_mutex_lock(&lock);
+            while (idle.empty() && !stopped)
+                pthread_cond_wait(&cond, &lock);
+            if (stopped) {
+                pthread_mutex_unlock(&lock);
+                return;
+            }
+            b = idle.front();
+            idle.pop_front();
+            pthread_mutex_unlock(&lock);
+
+            try {
+                fill(b);
+            }
+            catch (exception &e) {
+                message = e.what();
+            }
+
+            pthread_mutex_lock(&lock);
+            bool done = b->used < COMPRESSED_IO_BUFFER || !message.empty();
+            if (b->used > 0)
+                filled.push_back(b);
+            else
+                idle.push_back(b);
+            if (done) {
+                finished = true;
+                error    = message;
+            }
+            pthread_cond_broadcast(&cond);
+            pthread_mutex_unlock(&lock);
+
+            if (done) return;
+        }
+    }
+
+    // moves on to the next buffer of decompressed data, returns false at end of data.
+    bool CompressedIO::next() {
+        if (writer)
+            throw RuntimeError("CompressedIO: cannot read from a stream opened for writing");
+
+        if (!threaded) {
+            current = &buffers[0];
+            fill(current);
+            return current->used > 0;
+        }
+
+        string message;
+        pthread_mutex_lock(&lock);
+        if (current) {
+            idle.push_back(current);
+            current = 0;
+            pthread_cond_broadcast(&cond);
+        }
+        while (filled.empty() && !finished)
+            pthread_cond_wait(&cond, &lock);
+        if (!filled.empty()) {
+            current = filled.front();
+            filled.pop_front();
+        }
+        else
+            message = error;
+        pthread_mutex_unlock(&lock);
+
+        if (!message.empty())
+            throw RuntimeError(message);
+
+        return current != 0;
+    }
+
+    uint64_t CompressedIO::read(const char **data, uint64_t len) {
+        while (!current || current->rpos == current->used) {
+            if (!next()) return 0;
+        }
+
+        uint64_t max = current->used - current->rpos;
+        len   = len > max ? max : len;
+        *data = current->data + current->rpos;
+        current->rpos += len;
+        return len;
+    }
+
+    uint32_t CompressedIO::read(char *buffer, uint32_t size) {
+        const char *chunk;
+        uint32_t len, total = 0;
+
+        while (total < size && (len = read(&chunk, size - total)) > 0) {
+            memcpy(buffer + total, chunk, len);
+            total += len;
+        }
+
+        return total;
+    }
+
+    string& CompressedIO::read() {
+        const char *chunk;
+        uint64_t len = read(&chunk, 16384);
+        if (len > 0) {
+            stringdata = string(chunk, len);
+            return stringdata;
+        }
+        return empty;
+    }
+
+    bool CompressedIO::readline(string &line) {
+        bool found = false;
+        line.clear();
+
+        while (!found) {
+            if (!current || current->rpos == current->used) {
+                if (!next()) return line.length() > 0;
+            }
+
+            char *start = current->data + current->rpos, *end;
+            uint64_t size = current->used - current->rpos;
+
+            if ((end = (char*)memchr(start, '\n', size))) {
+                size  = end - start;
+                found = true;
+            }
+
+            line.append(start, size);
+            current->rpos += found ? size + 1 : size;
+        }
+
+        return true;
+    }
+
+    char* CompressedIO::readline() {
+        return readline(stringdata) ? (char*)stringdata.c_str() : 0;
+    }
+
+    // compresses data into the output buffer, writing it to io whenever it fills up.
+    void CompressedIO::compress(const char *data, uint64_t len, bool end) {
+        switch (codec) {
+#ifdef HAS_ZLIB
+            case DBI_CODEC_GZIP: {
+                int rc;
+                z_stream *z = (z_stream*)stream;
+                z->next_in  = (Bytef*)data;
+                z->avail_in = len;
+                do {
+                    z->next_out  = (Bytef*)current->data + current->used;
+                    z->avail_out = COMPRESSED_IO_BUFFER - current->used;
+
+                    if ((rc = deflate(z, end ? Z_FINISH : Z_NO_FLUSH)) == Z_STREAM_ERROR)
+                        throw RuntimeError("CompressedIO: gzip stream error");
+
+                    current->used = COMPRESSED_IO_BUFFER - z->avail_out;
+                    if (current->used == COMPRESSED_IO_BUFFER) {
+                        io->write(current->data, current->used);
+                        current->used = 0;
+                    }
+                } while (end ? rc != Z_STREAM_END : z->avail_in > 0);
+                break;
+            }
+#endif
+#ifdef HAS_ZSTD
+            case DBI_CODEC_ZSTD: {
+                size_t rc;
+                ZSTD_inBuffer in = {data, len, 0};
+                do {
+                    ZSTD_outBuffer out = {current->data, COMPRESSED_IO_BUFFER, current->used};
+
+                    rc = end ? ZSTD_endStream((ZSTD_CStream*)stream, &out)
+                             : ZSTD_compressStream((ZSTD_CStream*)stream, &out, &in);
+                    if (ZSTD_isError(rc))
+                        throw RuntimeError(ZSTD_getErrorName(rc));
+
+                    current->used = out.pos;
+                    if (current->used == COMPRESSED_IO_BUFFER) {
+                        io->write(current->data, current->used);
+                        current->used = 0;
+                    }
+                } while (end ? rc != 0 : in.pos < in.size);
+                break;
+            }
+#endif
+        }
+
+        if (end && current->used > 0) {
+            io->write(current->data, current->used);
+            current->used = 0;
+        }
+    }
+
+    void CompressedIO::write(const char *data, uint64_t len) {
+        if (!writer || closed)
+            throw RuntimeError("CompressedIO: stream is not open for writing");
+        compress(data, len, false);
+    }
+
+    void CompressedIO::write(const char *data) {
+        write(data, strlen(data));
+    }
+
+    void CompressedIO::finish() {
+        if (writer && !closed) {
+            closed = true;
+            compress(0, 0, true);
+        }
+    }
+
+    void CompressedIO::truncate() {
+        // NOP
+    }
+}
@@ -55,6 +55,15 @@ namespace dbi {
         return rs;
     }
 
+    uint64_t ResultRowHash::bytes() {
+        uint64_t total = 0;
+
+        for(map<string,Param>::iterator iter = data.begin(); iter != data.end(); ++iter)
+            total += iter->second.value.length();
+
+        return total;
+    }
+
     ostream& operator<< (ostream &out, ResultRowHash &r) {
         for(map<string,Param>::iterator iter = r.data.begin(); iter != r.data.end();) {
             out << iter->first << "\t" << iter->second;
@@ -94,4 +103,16 @@ namespace dbi {
     int FieldSet::size() {
         return fields.size();
     }
+
+    //--------------------------------------------------------------------------
+    // RowList
+    //--------------------------------------------------------------------------
+
+    RowList::RowList(row_list_t &rows) : list(rows) {
+        position = 0;
+    }
+
+    ResultRow* RowList::next() {
+        return position < list.size() ? &list[position++] : 0;
+    }
 }
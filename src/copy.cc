@@ -0,0 +1,209 @@
+#include "dbic++.h"
+#include <sched.h>
+
+// rows per batch and number of batches the reader can run ahead of the writer.
+#define COPY_BATCH_ROWS 1024
+#define COPY_QUEUE      8
+
+namespace dbi {
+
+    struct CopyBatch {
+        row_list_t rows;
+        uint32_t count;
+        bool last;
+    };
+
+    // single producer, single consumer ring. head is only written by the consumer and
+    // tail only by the producer, the release store publishes the slot contents.
+    class CopyRing {
+        protected:
+        CopyBatch *slots[COPY_QUEUE + 3];
+        uint32_t head, tail;
+
+        public:
+        CopyRing() : head(0), tail(0) {}
+
+        bool push(CopyBatch *batch) {
+            uint32_t next = (tail + 1) % (COPY_QUEUE + 3);
+            if (next == __atomic_load_n(&head, __ATOMIC_ACQUIRE)) return false;
+            slots[tail] = batch;
+            __atomic_store_n(&tail, next, __ATOMIC_RELEASE);
+            return true;
+        }
+
+        CopyBatch* pop() {
+            if (head == __atomic_load_n(&tail, __ATOMIC_ACQUIRE)) return 0;
+            CopyBatch *batch = slots[head];
+            __atomic_store_n(&head, (head + 1) % (COPY_QUEUE + 3), __ATOMIC_RELEASE);
+            return batch;
+        }
+    };
+
+    // spins briefly before yielding and finally sleeping, waits are usually short when
+    // both sides keep up and long when one of the databases stalls.
+    static void COPY_BACKOFF(int &spins) {
+        if (++spins < 100)
+            __sync_synchronize();
+        else if (spins < 200)
+            sched_yield();
+        else
+            usleep(100);
+    }
+
+    static void COPY_COUNT(CopyProgress *progress, uint64_t CopyProgress::*counter, uint64_t n) {
+        if (progress) __atomic_add_fetch(&(progress->*counter), n, __ATOMIC_RELAXED);
+    }
+
+    struct CopyState {
+        Handle *src;
+        string sql;
+        param_list_t *bind;
+        CopyProgress *progress;
+
+        // filled batches travel from reader to writer, drained ones come back.
+        CopyRing filled, drained;
+        CopyBatch batches[COPY_QUEUE + 2];
+
+        int cancelled;
+        bool failed;
+        string error;
+    };
+
+    // returns 0 once the writer has given up.
+    static CopyBatch* COPY_NEXT_DRAINED(CopyState *state) {
+        int spins = 0;
+        CopyBatch *batch;
+        while (true) {
+            if (__atomic_load_n(&state->cancelled, __ATOMIC_ACQUIRE)) return 0;
+            if ((batch = state->drained.pop())) break;
+            if (spins == 0) COPY_COUNT(state->progress, &CopyProgress::reader_waits, 1);
+            COPY_BACKOFF(spins);
+        }
+        return batch;
+    }
+
+    static void COPY_PUBLISH(CopyState *state, CopyBatch *batch) {
+        int spins = 0;
+        // the ring holds every batch, so this only spins until the writer's release is visible.
+        while (!state->filled.push(batch)) COPY_BACKOFF(spins);
+        COPY_COUNT(state->progress, &CopyProgress::batches, 1);
+    }
+
+    static void* COPY_READER(void *arg) {
+        CopyState *state = (CopyState*)arg;
+        CopyBatch *batch = COPY_NEXT_DRAINED(state);
+
+        if (!batch) return 0;
+
+        try {
+            Query query(*state->src, state->sql);
+            if (state->bind->size() > 0)
+                query.execute(*state->bind);
+            else
+                query.execute();
+
+            while (true) {
+                if (batch->count == COPY_BATCH_ROWS) {
+                    COPY_COUNT(state->progress, &CopyProgress::rows_read, batch->count);
+                    COPY_PUBLISH(state, batch);
+                    if (!(batch = COPY_NEXT_DRAINED(state))) return 0;
+                }
+
+                if (!query.read(batch->rows[batch->count])) break;
+                batch->count++;
+            }
+        }
+        catch (Error &e) {
+            state->failed = true;
+            state->error  = e.what();
+        }
+        catch (...) {
+            state->failed = true;
+            state->error  = "unknown error";
+        }
+
+        if (!state->failed) COPY_COUNT(state->progress, &CopyProgress::rows_read, batch->count);
+        batch->last = true;
+        COPY_PUBLISH(state, batch);
+        return 0;
+    }
+
+    // hands the rows of filled batches to Handle::writeRows.
+    class CopySource : public RowSource {
+        protected:
+        CopyState *state;
+        CopyBatch *batch;
+        uint32_t position;
+
+        public:
+        CopySource(CopyState *s) : state(s), batch(0), position(0) {}
+
+        ResultRow* next() {
+            while (!batch || position == batch->count) {
+                if (batch) {
+                    COPY_COUNT(state->progress, &CopyProgress::rows_written, batch->count);
+                    bool last   = batch->last;
+                    batch->last = false;
+                    batch->count = 0;
+                    state->drained.push(batch);
+                    batch = 0;
+                    if (last) return 0;
+                }
+
+                int spins = 0;
+                while (!(batch = state->filled.pop())) {
+                    if (spins == 0) COPY_COUNT(state->progress, &CopyProgress::writer_waits, 1);
+                    COPY_BACKOFF(spins);
+                }
+
+                position = 0;
+                if (batch->last && state->failed)
+                    throw RuntimeError("copy: error reading source, " + state->error);
+            }
+
+            return &batch->rows[position++];
+        }
+    };
+
+    uint64_t copy(Handle &src, string sql, param_list_t &bind, Handle &dst, string table, FieldSet &fields,
+        CopyProgress *progress) {
+
+        pthread_t reader;
+        uint64_t rows;
+        CopyState *state = new CopyState;
+
+        state->src       = &src;
+        state->sql       = sql;
+        state->bind      = &bind;
+        state->progress  = progress;
+        state->cancelled = 0;
+        state->failed    = false;
+
+        for (int n = 0; n < COPY_QUEUE + 2; n++) {
+            state->batches[n].rows.resize(COPY_BATCH_ROWS);
+            state->batches[n].count = 0;
+            state->batches[n].last  = false;
+            state->drained.push(&state->batches[n]);
+        }
+
+        if (pthread_create(&reader, 0, COPY_READER, state) != 0) {
+            delete state;
+            throw RuntimeError("copy: unable to start reader thread");
+        }
+
+        try {
+            CopySource source(state);
+            rows = dst.writeRows(table, fields, source);
+        }
+        catch (...) {
+            __atomic_store_n(&state->cancelled, 1, __ATOMIC_RELEASE);
+            pthread_join(reader, 0);
+            delete state;
+            throw;
+        }
+
+        pthread_join(reader, 0);
+        delete state;
+        return rows;
+    }
+}
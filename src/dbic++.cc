@@ -149,6 +149,11 @@ namespace dbi {
         return message;
     }
 
+    bool isQuery(string sql) {
+        static pcrecpp::RE re("^\\s*\\(?\\s*(select|with|values|table)\\b", pcrecpp::RE_Options().set_caseless(true));
+        return re.PartialMatch(sql);
+    }
+
     void logMessage(int fd, string msg) {
         long n;
         char buffer[512];
@@ -4,206 +4,28 @@
 #include <inttypes.h>
 
 namespace dbi {
-    void MySqlBinaryResult::set_zero_time(MYSQL_TIME *tm, enum enum_mysql_timestamp_type time_type) {
-        bzero((void*) tm, sizeof(*tm));
-        tm->time_type = time_type;
-    }
-
-    unsigned long MySqlBinaryResult::net_field_length(unsigned char **packet) {
-        unsigned char *pos= (unsigned char *)*packet;
-        if (*pos < 251) {
-            (*packet)++;
-            return (unsigned long) *pos;
-        }
-
-        if (*pos == 251) {
-            (*packet)++;
-            return NULL_LENGTH;
-        }
-
-        if (*pos == 252) {
-            (*packet) +=3;
-            return (unsigned long) uint2korr(pos+1);
-        }
-
-        if (*pos == 253) {
-            (*packet) +=4;
-            return (unsigned long) uint3korr(pos+1);
-        }
-
-        (*packet) +=9;                 /* Must be 254 when here */
-        return (unsigned long) uint4korr(pos+1);
-    }
-
-    void MySqlBinaryResult::read_binary_time(MYSQL_TIME* tm, unsigned char **pos) {
-        /* net_field_length will set pos to the first byte of data */
-        unsigned int length = net_field_length(pos);
-
-        if (length) {
-            unsigned char *to = *pos;
-
-            tm->neg         = to[0];
-            tm->day         = (unsigned long) sint4korr(to+1);
-            tm->hour        = (unsigned int) to[5];
-            tm->minute      = (unsigned int) to[6];
-            tm->second      = (unsigned int) to[7];
-            tm->second_part = (length > 8) ? (unsigned long) sint4korr(to+8) : 0;
-
-            tm->year = tm->month= 0;
-            if (tm->day) {
-                /* Convert days to hours at once */
-                tm->hour += tm->day*24;
-                tm->day = 0;
-            }
-            tm->time_type = MYSQL_TIMESTAMP_TIME;
-
-            *pos += length;
-        }
-        else
-            set_zero_time(tm, MYSQL_TIMESTAMP_TIME);
-    }
-
-    void MySqlBinaryResult::read_binary_datetime(MYSQL_TIME *tm, unsigned char **pos) {
-        unsigned int length = net_field_length(pos);
-
-        if (length) {
-            unsigned char *to = *pos;
-
-            tm->neg   = 0;
-            tm->year  = (unsigned int) sint2korr(to);
-            tm->month = (unsigned int) to[2];
-            tm->day   = (unsigned int) to[3];
-
-            if (length > 4) {
-                tm->hour   = (unsigned int) to[4];
-                tm->minute = (unsigned int) to[5];
-                tm->second = (unsigned int) to[6];
-            }
-            else {
-                tm->hour = tm->minute= tm->second= 0;
-            }
-
-            tm->second_part = (length > 7) ? (unsigned long) sint4korr(to+7) : 0;
-            tm->time_type   = MYSQL_TIMESTAMP_DATETIME;
-
-            *pos += length;
-        }
-        else
-          set_zero_time(tm, MYSQL_TIMESTAMP_DATETIME);
-    }
-
-    void MySqlBinaryResult::read_binary_date(MYSQL_TIME *tm, unsigned char **pos) {
-        unsigned int length= net_field_length(pos);
-
-        if (length) {
-            unsigned char *to = *pos;
-
-            tm->year  =  (unsigned int) sint2korr(to);
-            tm->month =  (unsigned int) to[2];
-            tm->day   =  (unsigned int) to[3];
-
-            tm->hour        = tm->minute= tm->second= 0;
-            tm->second_part = 0;
-            tm->neg         = 0;
-            tm->time_type   = MYSQL_TIMESTAMP_DATE;
-
-            *pos += length;
-        }
-        else
-            set_zero_time(tm, MYSQL_TIMESTAMP_DATE);
-    }
-
-    void MySqlBinaryResult::fetch_result_tinyint(int c, unsigned char **row) {
-        pool[c].length = 0;
-        snprintf((char*)pool[c].data, 5, "%d", **row);
-        (*row)++;
-    }
-
-    void MySqlBinaryResult::fetch_result_short(int c, unsigned char **row) {
-        pool[c].length = 0;
-        snprintf((char*)pool[c].data, 8, "%d", (int16_t) sint2korr(*row));
-        *row+= 2;
-    }
-
-    void MySqlBinaryResult::fetch_result_int32(int c, unsigned char **row) {
-        pool[c].length = 0;
-        snprintf((char*)pool[c].data, 16, "%d", (int32_t) sint4korr(*row));
-        *row+= 4;
-    }
-
-    void MySqlBinaryResult::fetch_result_int64(int c, unsigned char **row) {
-        pool[c].length = 0;
-        snprintf((char*)pool[c].data, 32, "%" PRIi64 , (int64_t) sint8korr(*row));
-        *row+= 8;
-    }
-
-    void MySqlBinaryResult::fetch_result_float(int c, unsigned char **row) {
-        float value;
-        pool[c].length = 0;
-        float4get(value, *row);
-        snprintf((char*)pool[c].data, 32, "%f", value);
-        *row+= 4;
-    }
-
-    void MySqlBinaryResult::fetch_result_double(int c, unsigned char **row) {
-        double value;
-        pool[c].length = 0;
-        float8get(value, *row);
-        snprintf((char*)pool[c].data, 64, "%lf", value);
-        *row+= 8;
-    }
-
-    void MySqlBinaryResult::fetch_result_time(int c, unsigned char **row) {
-        MYSQL_TIME tm;
-        pool[c].length = 0;
-        read_binary_time(&tm, row);
-        snprintf((char*)pool[c].data, 128, "%02d:%02d:%02d", tm.hour, tm.minute, tm.second);
-    }
-
-    void MySqlBinaryResult::fetch_result_date(int c, unsigned char **row) {
-        MYSQL_TIME tm;
-        pool[c].length = 0;
-        read_binary_date(&tm, row);
-        snprintf((char*)pool[c].data, 128, "%04d-%02d-%02d", tm.year, tm.month, tm.day);
-    }
-
-    void MySqlBinaryResult::fetch_result_datetime(int c, unsigned char **row) {
-        MYSQL_TIME tm;
-        pool[c].length = 0;
-        read_binary_datetime(&tm, row);
-        snprintf((char*)pool[c].data, 128, "%04d-%02d-%02d %02d:%02d:%02d", tm.year, tm.month, tm.day,
-                                                                            tm.hour, tm.minute, tm.second);
-    }
-
-    void MySqlBinaryResult::fetch_result_bin(int c, unsigned char **row) {
-        unsigned long length = net_field_length(row);
-        if (pool[c].alloc < length + 1) {
-            delete [] pool[c].data;
-            pool[c].data  = new unsigned char[length+1];
-            pool[c].alloc = length + 1;
-        }
-
-        memcpy(pool[c].data, (unsigned char *)*row, length);
-
-        pool[c].length       = length;
-        pool[c].data[length] = '\0';
-
-        *row+= length;
+    static void MYSQL_TIME_TO_TIMESTAMP(MYSQL_TIME &tm, Timestamp &t) {
+        t.year     = tm.year;
+        t.month    = tm.month;
+        t.day      = tm.day;
+        t.hour     = tm.hour;
+        t.minute   = tm.minute;
+        t.second   = tm.second;
+        t.usec     = tm.second_part;
+        t.tzoffset = 0;
     }
 
     void MySqlBinaryResult::fetchMeta() {
         int n;
-        MYSQL_FIELD *fields;
 
-        _cols  = mysql_num_fields(result);
-        _rows  = mysql_num_rows(result);
+        _cols    = mysql_num_fields(result);
+        metadata = mysql_fetch_fields(result);
 
-        fields = mysql_fetch_fields(result);
         for (n = 0; n < _cols; n++) {
-            _rsfields.push_back(fields[n].name);
-            switch(fields[n].type) {
+            _rsfields.push_back(metadata[n].name);
+            switch(metadata[n].type) {
                 case MYSQL_TYPE_TINY:
-                    _rstypes.push_back(fields[n].length == 1 ? DBI_TYPE_BOOLEAN : DBI_TYPE_INT);
+                    _rstypes.push_back(metadata[n].length == 1 ? DBI_TYPE_BOOLEAN : DBI_TYPE_INT);
                     break;
                 case MYSQL_TYPE_SHORT:
                 case MYSQL_TYPE_LONG:
@@ -231,86 +53,188 @@ namespace dbi {
                     _rstypes.push_back(DBI_TYPE_DATE);
                     break;
                 default:
-                    _rstypes.push_back((fields[n].flags & BINARY_FLAG) ? DBI_TYPE_BLOB : DBI_TYPE_TEXT);
+                    _rstypes.push_back((metadata[n].flags & BINARY_FLAG) ? DBI_TYPE_BLOB : DBI_TYPE_TEXT);
                     break;
             }
         }
     }
 
-    void MySqlBinaryResult::fetchRow() {
-        if (!cursor) return;
+    // numbers and times are converted by libmysql straight into the pool, text and blob
+    // fields are bound without a buffer so mysql_stmt_fetch() only reports their length
+    // and they are pulled with mysql_stmt_fetch_column() into a buffer of the right size.
+    void MySqlBinaryResult::bindResult(MYSQL_STMT *s) {
+        bind = new MYSQL_BIND[_cols];
+        bzero(bind, sizeof(MYSQL_BIND)*_cols);
 
-        unsigned char *nulls, *row = (unsigned char*)cursor->data, bit = 4;
+        for (int n = 0; n < _cols; n++) {
+            bind[n].is_null = &pool[n].null;
+            bind[n].length  = &pool[n].fetched;
+            bind[n].error   = &pool[n].error;
+
+            switch(_rstypes[n]) {
+                case DBI_TYPE_BOOLEAN:
+                case DBI_TYPE_INT:
+                    bind[n].buffer_type = MYSQL_TYPE_LONGLONG;
+                    bind[n].buffer      = &pool[n].value.i;
+                    bind[n].is_unsigned = (metadata[n].flags & UNSIGNED_FLAG) ? 1 : 0;
+                    break;
+                case DBI_TYPE_FLOAT:
+                    bind[n].buffer_type = MYSQL_TYPE_DOUBLE;
+                    bind[n].buffer      = &pool[n].value.f;
+                    break;
+                case DBI_TYPE_TIME:
+                case DBI_TYPE_DATE:
+                case DBI_TYPE_TIMESTAMP:
+                    bind[n].buffer_type = metadata[n].type;
+                    bind[n].buffer      = &pool[n].tm;
+                    break;
+                default:
+                    bind[n].buffer_type = MYSQL_TYPE_BLOB;
+                    break;
+            }
+        }
 
-        nulls = row;
-        row  += (_cols + 9) / 8;
-        // 2 reserved bits and 1 bit for each column to denote null value (byte aligned)
+        if (mysql_stmt_bind_result(s, bind) != 0) throw RuntimeError(mysql_stmt_error(s));
+    }
 
-        for (int j = 0; j < _cols; j++) {
-            if (*nulls & bit) {
-                pool[j].isnull = true;
+    void MySqlBinaryResult::step() {
+        int rc = mysql_stmt_fetch(stmt);
+        if (rc != 0 && rc != MYSQL_DATA_TRUNCATED) throw RuntimeError(mysql_stmt_error(stmt));
+    }
+
+    // fetches stored row r into the bound buffers. rows seen before are a mysql_stmt_row_seek()
+    // away, later ones are walked to once and indexed on the way, reading in order never seeks.
+    void MySqlBinaryResult::fetchStored(uint32_t r) {
+        if (r < offsets.size()) {
+            if (r != next_row) mysql_stmt_row_seek(stmt, offsets[r]);
+        }
+        else {
+            if (next_row != offsets.size()) {
+                mysql_stmt_row_seek(stmt, offsets.back());
+                step();
             }
-            else {
-                pool[j].isnull = false;
-                switch(result->fields[j].type) {
-                    case MYSQL_TYPE_TINY:
-                        fetch_result_tinyint(j, &row);
-                        break;
-                    case MYSQL_TYPE_SHORT:
-                        fetch_result_short(j, &row);
-                        break;
-                    case MYSQL_TYPE_LONG:
-                        fetch_result_int32(j, &row);
-                        break;
-                    case MYSQL_TYPE_LONGLONG:
-                        fetch_result_int64(j, &row);
-                        break;
-                    case MYSQL_TYPE_FLOAT:
-                        fetch_result_float(j, &row);
-                        break;
-                    case MYSQL_TYPE_DOUBLE:
-                        fetch_result_double(j, &row);
-                        break;
-                    case MYSQL_TYPE_TIMESTAMP:
-                    case MYSQL_TYPE_DATETIME:
-                        fetch_result_datetime(j, &row);
-                        break;
-                    case MYSQL_TYPE_TIME:
-                        fetch_result_time(j, &row);
-                        break;
-                    case MYSQL_TYPE_DATE:
-                        fetch_result_date(j, &row);
-                        break;
-                    /*
-                    TODO: check string and blob types and throw an error in default.
-                    case MYSQL_TYPE_TINY_BLOB:
-                    case MYSQL_TYPE_MEDIUM_BLOB:
-                    case MYSQL_TYPE_LONG_BLOB:
-                    case MYSQL_TYPE_BLOB:
-                    case MYSQL_TYPE_BIT:
-                        data = fetch_result_bin(&row, &length);
-                        break;
-                    */
-                    default:
-                        fetch_result_bin(j, &row);
-                        break;
-                }
+            while (offsets.size() < r) {
+                offsets.push_back(mysql_stmt_row_tell(stmt));
+                step();
             }
+            offsets.push_back(mysql_stmt_row_tell(stmt));
+        }
+
+        step();
+        next_row = r + 1;
+    }
+
+    // pulls text field c of the row just fetched into the pool.
+    void MySqlBinaryResult::fetchField(int c) {
+        uint64_t length = pool[c].fetched;
+
+        if (pool[c].alloc < length + 1) {
+            delete [] pool[c].data;
+            pool[c].data  = new unsigned char[length+1];
+            pool[c].alloc = length + 1;
+        }
+
+        if (length > 0) {
+            MYSQL_BIND column  = bind[c];
+            column.buffer        = pool[c].data;
+            column.buffer_length = length;
+            if (mysql_stmt_fetch_column(stmt, &column, c, 0) != 0)
+                throw RuntimeError(mysql_stmt_error(stmt));
+        }
+
+        pool[c].data[length] = '\0';
+        pool[c].value.data   = pool[c].data;
+        pool[c].value.length = length;
+        pool[c].text         = pool[c].data;
+        pool[c].length       = length;
+        pool[c].formatted    = true;
+    }
 
-            if (!((bit<<=1) & 255)) {
-                bit = 1;
-                nulls++;
+    // decodes the row mysql_stmt_fetch() has just left in the bound buffers.
+    void MySqlBinaryResult::fetchRow() {
+        for (int j = 0; j < _cols; j++) {
+            pool[j].value.type   = _rstypes[j];
+            pool[j].value.data   = 0;
+            pool[j].value.length = 0;
+            pool[j].formatted    = false;
+            pool[j].text         = 0;
+            pool[j].length       = 0;
+            pool[j].isnull       = (bool)pool[j].null;
+            pool[j].value.isnull = pool[j].isnull;
+
+            if (pool[j].isnull) continue;
+
+            switch(_rstypes[j]) {
+                case DBI_TYPE_TIME:
+                case DBI_TYPE_DATE:
+                case DBI_TYPE_TIMESTAMP:
+                    MYSQL_TIME_TO_TIMESTAMP(pool[j].tm, pool[j].value.t);
+                    break;
+                // fetched straight into value.
+                case DBI_TYPE_BOOLEAN:
+                case DBI_TYPE_INT:
+                case DBI_TYPE_FLOAT:
+                    break;
+                default:
+                    fetchField(j);
+                    break;
+            }
+        }
+    }
+
+    // text form of native values is only built when asked for, times get as many
+    // fractional digits as the column declares, same as the text protocol.
+    void MySqlBinaryResult::format(int c) {
+        static const int scale[] = {1000000, 100000, 10000, 1000, 100, 10, 1};
+        if (pool[c].isnull || pool[c].formatted) return;
+
+        switch (_rstypes[c]) {
+            case DBI_TYPE_TIME:
+            case DBI_TYPE_TIMESTAMP: {
+                Value value  = pool[c].value;
+                int decimals = metadata[c].decimals <= 6 ? metadata[c].decimals : 0;
+
+                value.t.usec   = 0;
+                pool[c].length = formatValue(value, (char*)pool[c].data, pool[c].alloc);
+                if (decimals > 0)
+                    pool[c].length += snprintf((char*)pool[c].data + pool[c].length, pool[c].alloc - pool[c].length,
+                                               ".%0*d", decimals, pool[c].value.t.usec / scale[decimals]);
+                break;
             }
+            default:
+                pool[c].length = formatValue(pool[c].value, (char*)pool[c].data, pool[c].alloc);
+                break;
         }
 
-        cursor = cursor->next;
+        pool[c].text      = pool[c].data;
+        pool[c].formatted = true;
     }
 
-    bool MySqlBinaryResult::read(ResultRow &row) {
-        if (_rowno >= _rows) return false;
+    bool MySqlBinaryResult::next() {
+        if (!stmt) return false;
+
+        if (_cursor) {
+            // mysql_stmt_fetch() fetches the next batch from the server as the previous one runs dry.
+            int rc = mysql_stmt_fetch(stmt);
+            if (rc == MYSQL_NO_DATA) {
+                release();
+                return false;
+            }
+            if (rc != 0 && rc != MYSQL_DATA_TRUNCATED) throw RuntimeError(mysql_stmt_error(stmt));
+            _rows++;
+        }
+        else if (_rowno < _rows)
+            fetchStored(_rowno);
+        else
+            return false;
 
         fetchRow();
         _rowno++;
+        return true;
+    }
+
+    bool MySqlBinaryResult::read(ResultRow &row) {
+        if (!next()) return false;
         row.resize(_cols);
 
         for (int n = 0; n < _cols; n++) {
@@ -319,9 +243,9 @@ namespace dbi {
                 row[n].value  = "";
             }
             else {
+                format(n);
                 row[n].isnull = false;
-                row[n].value  = pool[n].length > 0 ? string((char*)pool[n].data, pool[n].length)
-                                                   : string((char*)pool[n].data);
+                row[n].value  = string((char*)pool[n].text, pool[n].length);
                 row[n].binary = _rstypes[n] == DBI_TYPE_BLOB;
             }
         }
@@ -329,35 +253,50 @@ namespace dbi {
     }
 
     bool MySqlBinaryResult::read(ResultRowHash &rowhash) {
-        if (_rowno >= _rows) return false;
-        fetchRow();
+        if (!next()) return false;
 
-        _rowno++;
         rowhash.clear();
         for (int n = 0; n < _cols; n++) {
-            rowhash[_rsfields[n]] = pool[n].isnull ?
-                PARAM(null()) :
-                pool[n].length > 0 ? PARAM(pool[n].data, pool[n].length) : PARAM((char*)pool[n].data);
+            format(n);
+            rowhash[_rsfields[n]] = pool[n].isnull ? PARAM(null()) : PARAM(pool[n].text, pool[n].length);
         }
         return true;
     }
 
-    unsigned char* MySqlBinaryResult::read(uint32_t r, uint32_t c, uint64_t *length) {
-        if (r >= _rows || c >= _cols || r < 0 || c < 0) return 0;
+    // makes row r the buffered row, returns false if it does not exist.
+    bool MySqlBinaryResult::locate(uint32_t r) {
+        if (_cursor) {
+            // forward only, either the row we have or the one after it.
+            if (r + 1 == _rowno) return true;
+            if (r != _rowno) throw RuntimeError("Cursor results can only be read sequentially");
+            return next();
+        }
 
-        // if row data is not already buffered
-        if (r+1 != _rowno) {
-            // need first row
-            if (r == 0) rewind();
-            // or somewhere in the middle (r = _rowno is the next row to one already buffered).
-            else if (r != _rowno) seek(r);
+        if (r >= _rows || !stmt) return false;
 
+        // if row data is not already buffered
+        if (r + 1 != _rowno) {
+            fetchStored(r);
             fetchRow();
             _rowno = r + 1;
         }
 
-        if (length) *length = pool[c].isnull ? 0 : pool[c].length > 0 ? pool[c].length : strlen((char*)pool[c].data);
-        return pool[c].isnull ? 0 : (unsigned char*)pool[c].data;
+        return true;
+    }
+
+    unsigned char* MySqlBinaryResult::read(uint32_t r, uint32_t c, uint64_t *length) {
+        if (c >= _cols || !locate(r)) return 0;
+
+        format(c);
+        if (length) *length = pool[c].isnull ? 0 : pool[c].length;
+        return pool[c].isnull ? 0 : pool[c].text;
+    }
+
+    bool MySqlBinaryResult::read(uint32_t r, uint32_t c, Value &v) {
+        if (c >= _cols || !locate(r)) return false;
+
+        v = pool[c].value;
+        return true;
     }
 
     uint32_t MySqlBinaryResult::rows() {
@@ -385,65 +324,64 @@ namespace dbi {
     }
 
     void MySqlBinaryResult::seek(uint32_t n) {
-        if (n >= _rows) return;
+        if (_cursor) {
+            if (n != _rowno) throw RuntimeError("Cursor results cannot seek");
+            return;
+        }
 
+        if (n >= _rows) return;
         _rowno = n;
-        cursor = mysqldata;
-        while (cursor && n--) {
-            cursor = cursor->next;
-        }
     }
 
     void MySqlBinaryResult::rewind() {
-        cursor = mysqldata;
+        if (_cursor) return seek(0);
         _rowno = 0;
     }
 
-    MySqlBinaryResult::MySqlBinaryResult(MYSQL_STMT *stmt) {
-        pool   = 0;
-        _rows  = 0;
-        _cols  = 0;
-        _rowno = 0;
-
-        _affected_rows = POSITIVE_OR_ZERO(mysql_stmt_affected_rows(stmt));
-        last_insert_id = mysql_stmt_insert_id(stmt);
-
-        if ((result = mysql_stmt_result_metadata(stmt))) {
-            result->row_count = mysql_stmt_num_rows(stmt);
+    MySqlBinaryResult::MySqlBinaryResult(MYSQL_STMT *s, bool c) {
+        pool      = 0;
+        bind      = 0;
+        stmt      = 0;
+        metadata  = 0;
+        _owner    = 0;
+        _rows     = 0;
+        _cols     = 0;
+        _rowno    = 0;
+        next_row  = 0;
+        _cursor   = c;
+        _finalize = false;
+
+        _affected_rows = _cursor ? 0 : POSITIVE_OR_ZERO(mysql_stmt_affected_rows(s));
+        last_insert_id = mysql_stmt_insert_id(s);
+
+        if ((result = mysql_stmt_result_metadata(s))) {
+            _rows = _cursor ? 0 : mysql_stmt_num_rows(s);
             fetchMeta();
         }
 
-        // make a copy of the binary resultset.
-        mysqldata = cursor = 0;
-        if (_rows > 0) {
-            MYSQL_ROWS *next, *curr = stmt->result.data;
-            while (curr) {
-                next = new MYSQL_ROWS;
-                next->next   = 0;
-                next->length = curr->length;
-                next->data   = (char**)new unsigned char[curr->length];
-                memcpy(next->data, curr->data, curr->length);
-
-                if (cursor) {
-                    cursor->next = next;
-                    cursor = next;
-                }
-                else {
-                    mysqldata = cursor = next;
-                }
-
-                curr = curr->next;
-            }
-
-            cursor = mysqldata;
-
-            if (_cols > 0) pool = new ResultBuffer[_cols];
+        if (_cols > 0) {
+            pool = new ResultBuffer[_cols];
             for (int n = 0; n < _cols; n++) {
                 pool[n].data   = new unsigned char[1024];
                 pool[n].alloc  = 1024;
                 pool[n].length = 0;
+                pool[n].text   = 0;
             }
         }
+
+        try {
+            // rows are fetched from the server side cursor in batches as they are read, or
+            // from those buffered in the statement.
+            if (_cursor ? _cols > 0 : _rows > 0) {
+                stmt = s;
+                bindResult(s);
+                if (!_cursor) offsets.reserve(_rows);
+            }
+        }
+        catch (...) {
+            cleanup();
+            throw;
+        }
     }
 
     MySqlBinaryResult::~MySqlBinaryResult() {
@@ -456,18 +394,14 @@ namespace dbi {
             result = 0;
         }
 
-        if (mysqldata) {
-            cursor = mysqldata;
-            MYSQL_ROWS *next;
-            while (cursor) {
-                next = cursor->next;
-                if (cursor->length && cursor->data) delete [] (unsigned char*)cursor->data;
-                delete cursor;
-                cursor = next;
-            }
-            mysqldata = 0;
+        if (bind) {
+            delete [] bind;
+            bind = 0;
         }
 
+        release();
+        offsets.clear();
+
         if (pool) {
             for (int n = 0; n < _cols; n++) delete [] pool[n].data;
             delete [] pool;
@@ -475,6 +409,30 @@ namespace dbi {
         }
     }
 
+    // only results reading rows from the statement are tracked.
+    void MySqlBinaryResult::track(MySqlBinaryResult **owner) {
+        if (!stmt) return;
+        _owner = owner;
+        *owner = this;
+    }
+
+    // take over the MYSQL_STMT, it is closed along with the result.
+    void MySqlBinaryResult::adopt() {
+        if (_owner && *_owner == this) *_owner = 0;
+        _owner    = 0;
+        _finalize = true;
+    }
+
+    // done with the statement, reads past this point find no more rows.
+    void MySqlBinaryResult::release() {
+        if (_owner && *_owner == this) *_owner = 0;
+        if (_finalize && stmt) mysql_stmt_close(stmt);
+
+        _owner    = 0;
+        stmt      = 0;
+        _finalize = false;
+    }
+
     // NOP
 
     bool MySqlBinaryResult::finish() {
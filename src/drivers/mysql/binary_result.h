@@ -1,16 +1,22 @@
 #ifndef _DBICXX_MYSQL_BINARY_RESULT_H
 #define _DBICXX_MYSQL_BINARY_RESULT_H
 
-#include <my_global.h>
-#include <mysql_time.h>
-#include <m_string.h>
 #include <stdint.h>
 
 namespace dbi {
+    // value holds the decoded field, text is its text form and is only
+    // built on demand (formatted = true) for non string types. data is
+    // scratch space for formatting and text fields.
     struct ResultBuffer {
-        unsigned char *data;
+        unsigned char *data, *text;
         uint64_t length, alloc;
-        bool isnull;
+        bool isnull, formatted;
+        Value value;
+
+        // bound output of mysql_stmt_fetch()
+        MYSQL_TIME    tm;
+        unsigned long fetched;
+        my_bool       null, error;
     };
 
     class MySqlBinaryResult : public AbstractResult {
@@ -18,43 +24,40 @@ namespace dbi {
         string_list_t  _rsfields;
         int_list_t     _rstypes;
         uint32_t _rows, _cols, _rowno, _affected_rows;
+        bool _cursor, _finalize;
 
         protected:
-        MYSQL_RES  *result;
-        MYSQL_ROWS *mysqldata, *cursor;
-
-        ResultBuffer *pool;
-
-        uint64_t last_insert_id;
-
-        /* following methods have been stolen from mysql codebase for parsing binary resultset */
+        MYSQL_RES   *result;
+        MYSQL_FIELD *metadata;
+        MYSQL_STMT  *stmt;
+        MYSQL_BIND  *bind;
 
-        void set_zero_time(MYSQL_TIME*, enum enum_mysql_timestamp_type);
-        unsigned long STDCALL net_field_length(unsigned char**);
+        // rows are read in place from those mysql_stmt_store_result() buffered in the
+        // statement, offsets holds the position of each row passed so far and next is
+        // the row mysql_stmt_fetch() would return.
+        vector<MYSQL_ROW_OFFSET> offsets;
+        uint32_t next_row;
 
-        void read_binary_time(MYSQL_TIME*, unsigned char **);
-        void read_binary_datetime(MYSQL_TIME*, unsigned char **);
-        void read_binary_date(MYSQL_TIME*, unsigned char **);
+        // statement pointer to the result reading from it, see track().
+        MySqlBinaryResult **_owner;
 
-        void fetch_result_tinyint(int, unsigned char **);
-        void fetch_result_short(int, unsigned char**);
-        void fetch_result_int32(int, unsigned char**);
-        void fetch_result_int64(int, unsigned char**);
-        void fetch_result_float(int, unsigned char**);
-        void fetch_result_double(int, unsigned char**);
-        void fetch_result_time(int, unsigned char**);
-        void fetch_result_date(int, unsigned char**);
-        void fetch_result_datetime(int, unsigned char**);
-        void fetch_result_bin(int, unsigned char **);
+        ResultBuffer *pool;
 
-        /* end of stolen mysql code */
+        uint64_t last_insert_id;
 
-        void fetchRow();
         void fetchMeta();
+        void bindResult(MYSQL_STMT*);
+        void step();
+        void fetchStored(uint32_t r);
+        void fetchField(int);
+        void fetchRow();
+        bool next();
+        bool locate(uint32_t r);
+        void format(int c);
 
         public:
 
-        MySqlBinaryResult(MYSQL_STMT *);
+        MySqlBinaryResult(MYSQL_STMT *, bool cursor = false);
         ~MySqlBinaryResult();
 
         uint32_t        rows();
@@ -66,6 +69,7 @@ namespace dbi {
         bool read(ResultRow &);
         bool read(ResultRowHash &);
         unsigned char* read(uint32_t r, uint32_t c, uint64_t *len);
+        bool read(uint32_t r, uint32_t c, Value &v);
 
         uint32_t tell();
         void seek(uint32_t);
@@ -74,6 +78,12 @@ namespace dbi {
         void cleanup();
         bool finish();
 
+        // rows live in the statement, it releases the result before freeing them when it is
+        // executed again and hands the MYSQL_STMT over to it when destroyed.
+        void track(MySqlBinaryResult **owner);
+        void adopt();
+        void release();
+
         // NOP
         bool consumeResult();
         void prepareResult();
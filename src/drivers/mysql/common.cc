@@ -18,6 +18,16 @@ namespace dbi {
             re.Replace("?", &query);
     }
 
+    // mysql_real_query in its two halves, so the time to send and the time waiting on the server
+    // can be told apart.
+    int MYSQL_REAL_QUERY(MYSQL *conn, string &query) {
+        if (mysql_send_query(conn, query.c_str(), query.length()) != 0) return 1;
+        phaseLap(DBI_PHASE_SEND);
+        int rc = mysql_read_query_result(conn);
+        phaseLap(DBI_PHASE_WAIT);
+        return rc;
+    }
+
     void MYSQL_INTERPOLATE_BIND(MYSQL *conn, string &query, param_list_t &bind) {
         string_list_t parts;
         const char *cptr = query.c_str();
@@ -64,6 +74,12 @@ namespace dbi {
             error == CR_SERVER_LOST_EXTENDED || error == CR_COMMANDS_OUT_OF_SYNC);
     }
 
+    // an unbuffered result owns the connection until all its rows are read or it is freed.
+    void MYSQL_CHECK_READY(MYSQL *conn) {
+        if (conn && conn->status == MYSQL_STATUS_USE_RESULT)
+            throw RuntimeError("Connection is busy with an unbuffered result, read all rows or free it first.");
+    }
+
 
     int LOCAL_INFILE_INIT(void **ptr, const char *filename, void *unused) {
         *ptr = (void*)CopyInList[filename];
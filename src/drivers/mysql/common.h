@@ -14,6 +14,7 @@
 #define DRIVER_NAME             "mysql"
 #define DRIVER_VERSION          "1.3"
 #define __MYSQL_BIND_BUFFER_LEN 2048
+#define MYSQL_WRITE_BATCH       1000
 
 #define THROW_MYSQL_STMT_ERROR(s) {\
     snprintf(errormsg, 8192, "In SQL: %s\n\n %s", _sql.c_str(), mysql_stmt_error(s));\
@@ -33,7 +34,9 @@ namespace dbi {
 
     void MYSQL_PREPROCESS_QUERY(string &query);
     void MYSQL_INTERPOLATE_BIND(MYSQL *conn, string &query, param_list_t &bind);
+    int  MYSQL_REAL_QUERY(MYSQL *conn, string &query);
     bool MYSQL_CONNECTION_ERROR(int error);
+    void MYSQL_CHECK_READY(MYSQL *conn);
 
     int  LOCAL_INFILE_INIT(void **ptr, const char *filename, void *unused);
     int  LOCAL_INFILE_READ(void *ptr, char *buffer, uint32_t len);
@@ -4,12 +4,20 @@
 
 namespace dbi {
     MySqlHandle::MySqlHandle() {
-        tr_nesting = 0;
+        tr_nesting  = 0;
+        _result     = 0;
+        _streaming  = 0;
+        _unbuffered = false;
+        _prefetch   = 0;
+        conn        = 0;
     }
 
     MySqlHandle::MySqlHandle(string user, string pass, string dbname, string host, string port, char *options) {
         tr_nesting   = 0;
         _result      = 0;
+        _streaming   = 0;
+        _unbuffered  = false;
+        _prefetch    = 0;
 
         uint32_t _port = atoi(port.c_str());
 
@@ -47,6 +55,8 @@ namespace dbi {
             else if (option == "sslca")     { opt_ssl_ca   = value; ssl = true; }
             else if (option == "sslcapath") { opt_ssl_capath = value; ssl = true; }
             else if (option == "sslcipher") { opt_ssl_cipher = value; ssl = true; }
+            else if (option == "unbuffered") unbuffered(value == "1" || value == "true");
+            else if (option == "cursor")     cursor(atoi(value.c_str()));
         }
 
         if (ssl) {
@@ -82,7 +92,9 @@ namespace dbi {
 
     void MySqlHandle::cleanup() {
         if (conn) {
-            if (_result) mysql_free_result(_result);
+            if (_result)    mysql_free_result(_result);
+            // an unread unbuffered result needs the connection to discard its rows.
+            if (_streaming) _streaming->finish();
             mysql_close(conn);
         }
 
@@ -90,49 +102,57 @@ namespace dbi {
         conn       = 0;
     }
 
-    uint32_t MySqlHandle::execute(string sql) {
-        int rows;
-
+    // release the connection from any unbuffered result we still hold.
+    void MySqlHandle::checkReady() {
         if (_result) mysql_free_result(_result);
+        _result = 0;
+        MYSQL_CHECK_READY(conn);
+    }
 
-        _sql       = sql;
-        _result    = 0;
-
-        MYSQL_PREPROCESS_QUERY(sql);
-        if (mysql_real_query(conn, sql.c_str(), sql.length()) != 0) boom(mysql_error(conn));
-
-        rows = mysql_affected_rows(conn);
+    uint32_t MySqlHandle::storeResult() {
+        int rows = mysql_affected_rows(conn);
         if (rows < 0) {
-            _result = mysql_store_result(conn);
-            rows    = mysql_num_rows(_result);
+            // rows are fetched from the server as they are read, so the count is unknown here.
+            if (_unbuffered) {
+                if (!(_result = mysql_use_result(conn))) boom(mysql_error(conn));
+                return 0;
+            }
+
+            if (!(_result = mysql_store_result(conn))) boom(mysql_error(conn));
+            phaseLap(DBI_PHASE_FETCH);
+            rows = mysql_num_rows(_result);
         }
 
         return rows;
     }
 
-    uint32_t MySqlHandle::execute(string sql, param_list_t &bind) {
-        int rows;
+    uint32_t MySqlHandle::execute(string sql) {
+        checkReady();
+        _sql = sql;
 
-        if (_result) mysql_free_result(_result);
+        MYSQL_PREPROCESS_QUERY(sql);
+        phaseLap(DBI_PHASE_PREPROCESS);
+        if (MYSQL_REAL_QUERY(conn, sql) != 0) boom(mysql_error(conn));
 
-        _sql       = sql;
-        _result    = 0;
+        return storeResult();
+    }
+
+    uint32_t MySqlHandle::execute(string sql, param_list_t &bind) {
+        checkReady();
+        _sql = sql;
 
         MYSQL_PREPROCESS_QUERY(sql);
+        phaseLap(DBI_PHASE_PREPROCESS);
         MYSQL_INTERPOLATE_BIND(conn, sql, bind);
-        if (mysql_real_query(conn, sql.c_str(), sql.length()) != 0) boom(mysql_error(conn));
-
-        rows = mysql_affected_rows(conn);
-        if (rows < 0) {
-            _result = mysql_store_result(conn);
-            rows    = mysql_num_rows(_result);
-        }
+        phaseLap(DBI_PHASE_BIND);
+        if (MYSQL_REAL_QUERY(conn, sql) != 0) boom(mysql_error(conn));
 
-        return rows;
+        return storeResult();
     }
 
     AbstractResult* MySqlHandle::result() {
-        MySqlResult *rv = _result ? new MySqlResult(_result, _sql, conn) : new MySqlResult(0, _sql, conn);
+        MySqlResult *rv = new MySqlResult(_result, _sql, conn, _unbuffered && _result);
+        if (_unbuffered && _result) rv->track(&_streaming);
         _result = 0;
         return rv;
     }
@@ -142,16 +162,30 @@ namespace dbi {
     }
 
     MySqlResult* MySqlHandle::aexecute(string sql) {
+        checkReady();
         MYSQL_PREPROCESS_QUERY(sql);
         mysql_send_query(conn, sql.c_str(), sql.length());
-        return new MySqlResult(0, _sql, conn);
+        MySqlResult *rv = new MySqlResult(0, _sql, conn, _unbuffered);
+        if (_unbuffered) rv->track(&_streaming);
+        return rv;
     }
 
     MySqlResult* MySqlHandle::aexecute(string sql, param_list_t &bind) {
+        checkReady();
         MYSQL_PREPROCESS_QUERY(sql);
         MYSQL_INTERPOLATE_BIND(conn, sql, bind);
         mysql_send_query(conn, sql.c_str(), sql.length());
-        return new MySqlResult(0, _sql, conn);
+        MySqlResult *rv = new MySqlResult(0, _sql, conn, _unbuffered);
+        if (_unbuffered) rv->track(&_streaming);
+        return rv;
+    }
+
+    void MySqlHandle::unbuffered(bool flag) {
+        _unbuffered = flag;
+    }
+
+    void MySqlHandle::cursor(uint32_t prefetch) {
+        _prefetch = prefetch;
     }
 
     void MySqlHandle::async(bool flag) {
@@ -163,7 +197,8 @@ namespace dbi {
     }
 
     MySqlStatement* MySqlHandle::prepare(string sql) {
-        return new MySqlStatement(sql, conn);
+        checkReady();
+        return new MySqlStatement(sql, conn, _prefetch);
     }
 
     bool MySqlHandle::begin() {
@@ -217,11 +252,13 @@ namespace dbi {
 
     void MySqlHandle::reconnect() {
         if (conn) {
+            checkReady();
             if (tr_nesting > 0)
                 connectionError("Lost connection inside a transaction, unable to reconnect");
             if(mysql_ping(conn) != 0)
                 connectionError("Lost connection, unable to reconnect");
             else {
+                metrics::add(DBI_METRIC_RECONNECTS);
                 sprintf(errormsg, "NOTICE: Socket changed during auto reconnect to database %s on host %s\n",
                     _db.c_str(), _host.c_str());
                 if (_trace)
@@ -252,6 +289,7 @@ namespace dbi {
         char buffer[4096];
         string filename = generateCompactUUID();
 
+        checkReady();
         CopyInList[filename] = io;
 
         if (fields.size() > 0)
@@ -273,6 +311,173 @@ namespace dbi {
         return (uint64_t) mysql_affected_rows(conn);
     }
 
+    // rows are streamed with mysql_use_result and encoded in the default LOAD DATA format.
+    uint64_t MySqlHandle::read(string source, field_list_t &fields, IO* io) {
+        string sql;
+        MYSQL_ROW row;
+        MYSQL_RES *result;
+        TsvWriter tsv(io);
+
+        if (isQuery(source))
+            sql = source;
+        else
+            sql = "select " + (fields.size() > 0 ? fields.join(", ") : string("*")) + " from " + source;
+
+        checkReady();
+        if (_trace)
+            logMessage(_trace_fd, sql);
+
+        if (mysql_real_query(conn, sql.c_str(), sql.length()) != 0) boom(mysql_error(conn));
+        if (!(result = mysql_use_result(conn))) boom(mysql_error(conn));
+
+        int columns = mysql_num_fields(result);
+        try {
+            while ((row = mysql_fetch_row(result))) {
+                unsigned long *lengths = mysql_fetch_lengths(result);
+                for (int col = 0; col < columns; col++)
+                    tsv.write(row[col], lengths[col]);
+                tsv.end();
+            }
+            tsv.flush();
+        }
+        catch (...) {
+            // mysql_free_result reads and discards the remaining rows.
+            mysql_free_result(result);
+            throw;
+        }
+
+        bool failed = mysql_errno(conn) != 0;
+        mysql_free_result(result);
+        if (failed) boom(mysql_error(conn));
+
+        return tsv.rows();
+    }
+
+    uint64_t MySqlHandle::write(string table, field_list_t &fields, row_list_t &rows) {
+        RowList source(rows);
+        return writeRows(table, fields, source);
+    }
+
+    MYSQL_STMT* MySqlHandle::_prepare(string sql) {
+        char message[4096];
+        MYSQL_STMT *stmt = mysql_stmt_init(conn);
+
+        if (!stmt) boom("Unable to allocate statement");
+
+        if (_trace)
+            logMessage(_trace_fd, sql);
+
+        if (mysql_stmt_prepare(stmt, sql.c_str(), sql.length()) != 0) {
+            snprintf(message, 4096, "In SQL: %s\n\n %s", sql.c_str(), mysql_stmt_error(stmt));
+            mysql_stmt_close(stmt);
+            boom(message);
+        }
+
+        return stmt;
+    }
+
+    // insert with placeholders for nrows rows.
+    MYSQL_STMT* MySqlHandle::_prepareInsert(string table, field_list_t &fields, int columns, int nrows) {
+        string values = "(?";
+        for (int n = 1; n < columns; n++) values += ", ?";
+        values += ")";
+
+        string sql = "insert into " + table;
+        if (fields.size() > 0) sql += " (" + fields.join(", ") + ")";
+
+        sql += " values " + values;
+        for (int n = 1; n < nrows; n++) sql += ", " + values;
+
+        return _prepare(sql);
+    }
+
+    uint64_t MySqlHandle::_insertRows(MYSQL_STMT *stmt, row_list_t &rows, int nrows, int columns, MYSQL_BIND *params) {
+        char message[4096];
+        bzero(params, sizeof(MYSQL_BIND)*nrows*columns);
+
+        for (int r = 0, i = 0; r < nrows; r++) {
+            for (int c = 0; c < columns; c++, i++) {
+                Param &p = rows[r][c];
+                params[i].buffer        = (void *)p.value.data();
+                params[i].buffer_length = p.value.length();
+                params[i].is_null       = p.isnull ? &MYSQL_BOOL_TRUE : &MYSQL_BOOL_FALSE;
+                params[i].buffer_type   = p.isnull ? MYSQL_TYPE_NULL : p.binary ? MYSQL_TYPE_BLOB : MYSQL_TYPE_STRING;
+            }
+        }
+
+        if (mysql_stmt_bind_param(stmt, params) != 0 || mysql_stmt_execute(stmt) != 0) {
+            snprintf(message, 4096, "Error while writing rows: %s", mysql_stmt_error(stmt));
+            boom(message);
+        }
+
+        return mysql_stmt_affected_rows(stmt);
+    }
+
+    // rows are sent as multi row prepared inserts, batches of up to MYSQL_WRITE_BATCH rows
+    // share one statement. the load runs in its own transaction unless one is already open.
+    uint64_t MySqlHandle::writeRows(string table, field_list_t &fields, RowSource &source) {
+        char message[4096];
+        ResultRow *row;
+        uint64_t total = 0;
+        int columns, batch, count = 0;
+        MYSQL_STMT *full = 0, *stmt;
+
+        checkReady();
+
+        stmt = _prepare("select " + (fields.size() > 0 ? fields.join(", ") : string("*")) + " from " + table);
+        columns = mysql_stmt_field_count(stmt);
+        mysql_stmt_close(stmt);
+
+        // the protocol allows at most 65535 placeholders per statement.
+        batch = columns * MYSQL_WRITE_BATCH > 65535 ? 65535 / columns : MYSQL_WRITE_BATCH;
+
+        row_list_t rows(batch);
+        MYSQL_BIND *params = new MYSQL_BIND[batch*columns];
+        bool owner = !(conn->server_status & SERVER_STATUS_IN_TRANS);
+
+        try {
+            if (owner && mysql_real_query(conn, "begin", 5) != 0) boom(mysql_error(conn));
+
+            while ((row = source.next())) {
+                if (row->size() != columns) {
+                    snprintf(message, 4096, "Row %lu has %d values, expected %d", (unsigned long)(total + count), row->size(), columns);
+                    boom(message);
+                }
+
+                rows[count++] = *row;
+                if (count == batch) {
+                    if (!full) full = _prepareInsert(table, fields, columns, batch);
+                    total += _insertRows(full, rows, count, columns, params);
+                    count  = 0;
+                }
+            }
+
+            if (count > 0) {
+                stmt = _prepareInsert(table, fields, columns, count);
+                try {
+                    total += _insertRows(stmt, rows, count, columns, params);
+                }
+                catch (...) {
+                    mysql_stmt_close(stmt);
+                    throw;
+                }
+                mysql_stmt_close(stmt);
+            }
+
+            if (owner && mysql_real_query(conn, "commit", 6) != 0) boom(mysql_error(conn));
+        }
+        catch (...) {
+            if (full) mysql_stmt_close(full);
+            if (owner) mysql_real_query(conn, "rollback", 8);
+            delete [] params;
+            throw;
+        }
+
+        if (full) mysql_stmt_close(full);
+        delete [] params;
+        return total;
+    }
+
     string MySqlHandle::escape(string value) {
         char *dest = new char[value.length()*2 + 1];
         mysql_real_escape_string(conn, dest, value.data(), value.length());
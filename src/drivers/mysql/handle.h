@@ -11,6 +11,9 @@ namespace dbi {
         string _host;
         string _sql;
         MYSQL_RES *_result;
+        MySqlResult *_streaming;
+        bool _unbuffered;
+        uint32_t _prefetch;
 
         protected:
         int tr_nesting;
@@ -18,6 +21,12 @@ namespace dbi {
         void connectionError(const char *msg = 0);
         void runtimeError(const char *msg = 0);
         void parseOptions(char*);
+        void checkReady();
+        uint32_t storeResult();
+
+        MYSQL_STMT* _prepare(string sql);
+        MYSQL_STMT* _prepareInsert(string table, field_list_t &fields, int columns, int nrows);
+        uint64_t _insertRows(MYSQL_STMT*, row_list_t &rows, int nrows, int columns, MYSQL_BIND*);
 
         public:
         MYSQL *conn;
@@ -50,10 +59,16 @@ namespace dbi {
         void reconnect();
 
         uint64_t write(string table, field_list_t &fields, IO*);
+        uint64_t write(string table, field_list_t &fields, row_list_t &rows);
+        uint64_t writeRows(string table, field_list_t &fields, RowSource &source);
+        uint64_t read(string table_or_query, field_list_t &fields, IO*);
         void setTimeZoneOffset(int, int);
         void setTimeZone(char *name);
         string escape(string);
         string driver();
+
+        void unbuffered(bool);
+        void cursor(uint32_t prefetch);
     };
 }
 
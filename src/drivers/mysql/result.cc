@@ -1,23 +1,58 @@
 #include "common.h"
 
 namespace dbi {
-    MySqlResult::MySqlResult(MYSQL_RES *r, string sql, MYSQL *c) {
+    MySqlResult::MySqlResult(MYSQL_RES *r, string sql, MYSQL *c, bool unbuffered) {
         _rows          = 0;
         _cols          = 0;
         _rowno         = 0;
         _affected_rows = 0;
+        _unbuffered    = unbuffered;
+        _owner         = 0;
 
         conn   = c;
         result = r;
 
         if (conn) {
             last_insert_id = mysql_insert_id(conn);
-            _affected_rows = POSITIVE_OR_ZERO(mysql_affected_rows(conn));
+            // affected rows is not set until an unbuffered result has been read completely.
+            if (!_unbuffered) _affected_rows = POSITIVE_OR_ZERO(mysql_affected_rows(conn));
         }
 
         if (result) fetchMeta(result);
     }
 
+    void MySqlResult::track(MySqlResult **owner) {
+        _owner  = owner;
+        *_owner = this;
+    }
+
+    void MySqlResult::release() {
+        if (_owner && *_owner == this) *_owner = 0;
+        _owner = 0;
+    }
+
+    // unbuffered results pull rows off the wire, _rows counts the ones seen so far.
+    bool MySqlResult::fetchRow() {
+        if (!result) return false;
+
+        if (_unbuffered) {
+            if (!(_rowdata = mysql_fetch_row(result))) {
+                release();
+                if (mysql_errno(conn)) throw RuntimeError(mysql_error(conn));
+                return false;
+            }
+            _rows++;
+        }
+        else {
+            if (_rowno >= _rows) return false;
+            _rowdata = mysql_fetch_row(result);
+        }
+
+        _rowdata_lengths = mysql_fetch_lengths(result);
+        _rowno++;
+        return true;
+    }
+
     MySqlResult::~MySqlResult() {
         cleanup();
     }
@@ -31,14 +66,9 @@ namespace dbi {
     }
 
     bool MySqlResult::read(ResultRow &row) {
-        if (!result) return false;
-
-        if (_rowno < _rows) {
-            _rowno++;
+        if (fetchRow()) {
             row.resize(_cols);
 
-            _rowdata         = mysql_fetch_row(result);
-            _rowdata_lengths = mysql_fetch_lengths(result);
             for (int n = 0; n < _cols; n++) {
                 if(_rowdata[n] == 0) {
                     row[n].isnull = true;
@@ -57,15 +87,9 @@ namespace dbi {
     }
 
     bool MySqlResult::read(ResultRowHash &rowhash) {
-        if (!result) return false;
-
-        if (_rowno < _rows) {
-            _rowno++;
+        if (fetchRow()) {
             rowhash.clear();
 
-            _rowdata         = mysql_fetch_row(result);
-            _rowdata_lengths = mysql_fetch_lengths(result);
-
             for (int n = 0; n < _cols; n++)
                 rowhash[_rsfields[n]] = (
                     _rowdata[n] == 0 ? PARAM(null()) : PARAM((unsigned char*)_rowdata[n], _rowdata_lengths[n])
@@ -77,6 +101,18 @@ namespace dbi {
     }
 
     unsigned char* MySqlResult::read(uint32_t r, uint32_t c, uint64_t *l) {
+        if (_unbuffered) {
+            if (c >= _cols) return 0;
+            // forward only, either the row we have or the one after it.
+            if (r+1 != _rowno) {
+                if (r != _rowno) throw RuntimeError("Unbuffered results can only be read sequentially");
+                if (!fetchRow()) return 0;
+            }
+
+            if (l) *l = _rowdata_lengths[c];
+            return (unsigned char*)_rowdata[c];
+        }
+
         if (r >= _rows || c >= _cols || r < 0 || c < 0) return 0;
 
         // if row data is not already buffered
@@ -95,13 +131,31 @@ namespace dbi {
         return (unsigned char*)_rowdata[c];
     }
 
+    bool MySqlResult::read(uint32_t r, uint32_t c, Value &v) {
+        if (c >= _cols) return false;
+
+        uint64_t length = 0;
+        unsigned char *data = read(r, c, &length);
+        // read() leaves _rowno just past the row it fetched.
+        if (_rowno != r + 1) return false;
+
+        parseValue(_rstypes[c], data, length, v);
+        return true;
+    }
+
     bool MySqlResult::finish() {
         if (result) mysql_free_result(result);
         result = 0;
+        release();
         return true;
     }
 
     void MySqlResult::seek(uint32_t r) {
+        if (_unbuffered) {
+            if (r != _rowno) throw RuntimeError("Unbuffered results cannot seek");
+            return;
+        }
+
         mysql_data_seek(result, r);
         _rowno = r;
     }
@@ -137,12 +191,13 @@ namespace dbi {
 
     void MySqlResult::prepareResult() {
         if (conn) {
-            result = mysql_store_result(conn);
-            fetchMeta(result);
+            result = _unbuffered ? mysql_use_result(conn) : mysql_store_result(conn);
+            if (result) fetchMeta(result);
+            else release();
         }
 
         last_insert_id = mysql_insert_id(conn);
-        _affected_rows = POSITIVE_OR_ZERO(mysql_affected_rows(conn));
+        if (!_unbuffered || !result) _affected_rows = POSITIVE_OR_ZERO(mysql_affected_rows(conn));
     }
 
     void MySqlResult::fetchMeta(MYSQL_RES* result) {
@@ -192,8 +247,7 @@ namespace dbi {
     }
 
     void MySqlResult::rewind() {
-        _rowno = 0;
-        mysql_data_seek(result, 0);
+        seek(0);
     }
 
     string_list_t& MySqlResult::fields() {
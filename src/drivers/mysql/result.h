@@ -8,6 +8,7 @@ namespace dbi {
         uint32_t _cols;
         uint32_t _rowno;
         uint32_t _affected_rows;
+        bool     _unbuffered;
 
         string_list_t _rsfields;
         int_list_t    _rstypes;
@@ -15,17 +16,24 @@ namespace dbi {
         MYSQL_ROW _rowdata;
         unsigned long* _rowdata_lengths;
 
+        // handle slot that points to us while we hold the connection.
+        MySqlResult **_owner;
+
         protected:
         MYSQL *conn;
         MYSQL_RES *result;
         uint64_t last_insert_id;
 
         void fetchMeta(MYSQL_RES* result);
+        bool fetchRow();
+        void release();
 
         public:
-        MySqlResult(MYSQL_RES*, string, MYSQL*);
+        MySqlResult(MYSQL_RES*, string, MYSQL*, bool unbuffered = false);
         ~MySqlResult();
 
+        void track(MySqlResult **owner);
+
         void checkReady(string m);
         bool consumeResult();
         void prepareResult();
@@ -39,6 +47,7 @@ namespace dbi {
         bool read(ResultRow &r);
         bool read(ResultRowHash &r);
         unsigned char* read(uint32_t r, uint32_t c, uint64_t *l = 0);
+        bool           read(uint32_t r, uint32_t c, Value &v);
 
         uint32_t tell();
         void seek(uint32_t);
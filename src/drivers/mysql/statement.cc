@@ -2,19 +2,29 @@
 
 namespace dbi {
     void MySqlStatement::init() {
-        _stmt   = 0;
+        _stmt      = 0;
+        _prefetch  = 0;
+        _streaming = 0;
     }
 
     MySqlStatement::~MySqlStatement() {
         cleanup();
     }
 
-    MySqlStatement::MySqlStatement(string sql, MYSQL *c) {
+    MySqlStatement::MySqlStatement(string sql, MYSQL *c, uint32_t prefetch) {
         init();
 
-        conn  = c;
-        _sql  = sql;
-        _stmt = mysql_stmt_init(conn);
+        conn      = c;
+        _sql      = sql;
+        _stmt     = mysql_stmt_init(conn);
+        _prefetch = prefetch;
+
+        // read only server side cursor, rows are fetched in batches of _prefetch rows.
+        if (_prefetch > 0) {
+            unsigned long type = CURSOR_TYPE_READ_ONLY, rows = _prefetch;
+            mysql_stmt_attr_set(_stmt, STMT_ATTR_CURSOR_TYPE,   &type);
+            mysql_stmt_attr_set(_stmt, STMT_ATTR_PREFETCH_ROWS, &rows);
+        }
 
         MYSQL_PREPROCESS_QUERY(sql);
         if (mysql_stmt_prepare(_stmt, sql.c_str(), sql.length()) != 0)
@@ -27,12 +37,15 @@ namespace dbi {
 
     uint32_t MySqlStatement::execute() {
         finish();
+        MYSQL_CHECK_READY(conn);
         if (mysql_stmt_execute(_stmt) != 0) THROW_MYSQL_STMT_ERROR(_stmt);
+        phaseLap(DBI_PHASE_WAIT);
         return storeResult();
     }
 
     uint32_t MySqlStatement::execute(param_list_t &bind) {
         finish();
+        MYSQL_CHECK_READY(conn);
 
         MYSQL_BIND *params = new MYSQL_BIND[bind.size()];
         bzero(params, sizeof(MYSQL_BIND)*bind.size());
@@ -48,6 +61,7 @@ namespace dbi {
             delete [] params;
             THROW_MYSQL_STMT_ERROR(_stmt);
         }
+        phaseLap(DBI_PHASE_BIND);
 
         if (mysql_stmt_execute(_stmt) != 0) {
             delete [] params;
@@ -55,20 +69,33 @@ namespace dbi {
         }
 
         delete [] params;
+        phaseLap(DBI_PHASE_WAIT);
         return storeResult();
     }
 
     uint32_t MySqlStatement::storeResult() {
+        // rows are fetched lazily from the cursor, the row count is not known upfront.
+        if (_prefetch > 0 && mysql_stmt_field_count(_stmt) > 0) return 0;
+
         if (mysql_stmt_store_result(_stmt) != 0 ) THROW_MYSQL_STMT_ERROR(_stmt);
+        phaseLap(DBI_PHASE_FETCH);
         uint32_t rows = mysql_stmt_num_rows(_stmt);
         return rows ? rows : mysql_stmt_affected_rows(_stmt);
     }
 
     void MySqlStatement::finish() {
+        // a result still reading the rows or cursor of _stmt is done once they are freed.
+        if (_streaming) _streaming->release();
         if (_stmt) mysql_stmt_free_result(_stmt);
     }
 
+    // a result still reading from _stmt takes it over and closes it when done.
     void MySqlStatement::cleanup() {
+        if (_streaming) {
+            _streaming->adopt();
+            _stmt = 0;
+        }
+
         finish();
         if (_stmt) mysql_stmt_close(_stmt);
 
@@ -84,7 +111,10 @@ namespace dbi {
     }
 
     MySqlBinaryResult* MySqlStatement::result() {
-        return new MySqlBinaryResult(_stmt);
+        MySqlBinaryResult *instance = new MySqlBinaryResult(_stmt, _prefetch > 0 && mysql_stmt_field_count(_stmt) > 0);
+        if (_streaming) _streaming->release();
+        instance->track(&_streaming);
+        return instance;
     }
 
     uint64_t MySqlStatement::lastInsertID() {
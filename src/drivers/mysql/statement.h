@@ -10,6 +10,10 @@ namespace dbi {
         string _sql;
 
         MYSQL_STMT *_stmt;
+        uint32_t _prefetch;
+
+        // result reading rows that live in _stmt, if any.
+        MySqlBinaryResult *_streaming;
 
         protected:
         MYSQL *conn;
@@ -20,7 +24,7 @@ namespace dbi {
 
         public:
         ~MySqlStatement();
-        MySqlStatement(string sql, MYSQL *conn);
+        MySqlStatement(string sql, MYSQL *conn, uint32_t prefetch = 0);
 
         string command();
 
@@ -0,0 +1,173 @@
+#include "bytea.h"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PQ_HEX_SIMD 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+namespace dbi {
+
+    static const signed char hexmap[256] = {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+         0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+        -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+    };
+
+    static bool hexDecodeScalar(const unsigned char *in, uint64_t len, unsigned char *out) {
+        for (uint64_t i = 0; i + 1 < len; i += 2) {
+            int hi = hexmap[in[i]], lo = hexmap[in[i+1]];
+            if ((hi | lo) < 0) return false;
+            *out++ = (unsigned char)((hi << 4) | lo);
+        }
+        return true;
+    }
+
+#ifdef PQ_HEX_SIMD
+    // 16 hex digits to nibbles: (c & 0x0f) + 9 for letters, which are the only digits with bit 6 set.
+    // returns false if any of them is not a hex digit.
+    static inline bool nibbles128(__m128i c, __m128i *v) {
+        const __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+        const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                            _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c));
+        const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                            _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), lower));
+
+        if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xffff) return false;
+
+        const __m128i letter = _mm_cmpeq_epi8(_mm_and_si128(c, _mm_set1_epi8(0x40)), _mm_set1_epi8(0x40));
+        *v = _mm_add_epi8(_mm_and_si128(c, _mm_set1_epi8(0x0f)), _mm_and_si128(letter, _mm_set1_epi8(9)));
+        return true;
+    }
+
+    // pairs of nibbles in 16 bit lanes (first digit in the low byte) to bytes in the low byte.
+    static inline __m128i pairs128(__m128i v) {
+        return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x00ff)), 4), _mm_srli_epi16(v, 8));
+    }
+
+    static bool hexDecodeSSE2(const unsigned char *in, uint64_t len, unsigned char *out) {
+        __m128i a, b;
+        uint64_t i = 0;
+
+        for (; i + 32 <= len; i += 32, out += 16) {
+            if (!nibbles128(_mm_loadu_si128((const __m128i*)(in + i)), &a)) return false;
+            if (!nibbles128(_mm_loadu_si128((const __m128i*)(in + i + 16)), &b)) return false;
+            _mm_storeu_si128((__m128i*)out, _mm_packus_epi16(pairs128(a), pairs128(b)));
+        }
+
+        return hexDecodeScalar(in + i, len - i, out);
+    }
+
+    __attribute__((target("avx2")))
+    static inline bool nibbles256(__m256i c, __m256i *v) {
+        const __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+        const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+                                               _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+        const __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                               _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+
+        if (_mm256_movemask_epi8(_mm256_or_si256(digit, alpha)) != -1) return false;
+
+        const __m256i letter = _mm256_cmpeq_epi8(_mm256_and_si256(c, _mm256_set1_epi8(0x40)), _mm256_set1_epi8(0x40));
+        *v = _mm256_add_epi8(_mm256_and_si256(c, _mm256_set1_epi8(0x0f)), _mm256_and_si256(letter, _mm256_set1_epi8(9)));
+        return true;
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256i pairs256(__m256i v) {
+        return _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(v, _mm256_set1_epi16(0x00ff)), 4),
+                               _mm256_srli_epi16(v, 8));
+    }
+
+    __attribute__((target("avx2")))
+    static bool hexDecodeAVX2(const unsigned char *in, uint64_t len, unsigned char *out) {
+        __m256i a, b;
+        uint64_t i = 0;
+
+        for (; i + 64 <= len; i += 64, out += 32) {
+            if (!nibbles256(_mm256_loadu_si256((const __m256i*)(in + i)), &a)) return false;
+            if (!nibbles256(_mm256_loadu_si256((const __m256i*)(in + i + 32)), &b)) return false;
+            // packus works within 128 bit lanes, put the quadwords back in order.
+            __m256i packed = _mm256_packus_epi16(pairs256(a), pairs256(b));
+            _mm256_storeu_si256((__m256i*)out, _mm256_permute4x64_epi64(packed, 0xd8));
+        }
+
+        return hexDecodeSSE2(in + i, len - i, out);
+    }
+
+    typedef bool (*hex_decoder_t)(const unsigned char *, uint64_t, unsigned char *);
+
+    static hex_decoder_t hexDecoder() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? hexDecodeAVX2 : hexDecodeSSE2;
+    }
+#endif
+
+    bool PQ_HEX_DECODE(const unsigned char *in, uint64_t len, unsigned char *out) {
+        if (len & 1) return false;
+#ifdef PQ_HEX_SIMD
+        static hex_decoder_t decoder = hexDecoder();
+        return decoder(in, len, out);
+#else
+        return hexDecodeScalar(in, len, out);
+#endif
+    }
+
+    // pre 9.0 escape format, \\ for a backslash and \ooo for non printable bytes.
+    static int64_t escapeDecode(const unsigned char *in, uint64_t len, unsigned char *out) {
+        unsigned char *start = out;
+
+        for (uint64_t i = 0; i < len; i++) {
+            if (in[i] != '\\') {
+                *out++ = in[i];
+            }
+            else if (i + 1 < len && in[i+1] == '\\') {
+                *out++ = '\\';
+                i++;
+            }
+            else if (i + 3 < len && in[i+1] >= '0' && in[i+1] <= '3' && in[i+2] >= '0' && in[i+2] <= '7'
+                                 && in[i+3] >= '0' && in[i+3] <= '7') {
+                *out++ = (unsigned char)(((in[i+1] - '0') << 6) | ((in[i+2] - '0') << 3) | (in[i+3] - '0'));
+                i += 3;
+            }
+            else return -1;
+        }
+
+        return out - start;
+    }
+
+    int64_t PQ_BYTEA_DECODE(const unsigned char *in, uint64_t len, unsigned char **buffer, uint64_t *size) {
+        bool hex    = len >= 2 && in[0] == '\\' && in[1] == 'x';
+        uint64_t need = hex ? (len - 2) / 2 : len;
+
+        if (*size < need + 1 || !*buffer) {
+            delete [] *buffer;
+            *size   = need + 1;
+            *buffer = new unsigned char[*size];
+        }
+
+        if (hex) {
+            if (!PQ_HEX_DECODE(in + 2, len - 2, *buffer)) return -1;
+            (*buffer)[need] = 0;
+            return need;
+        }
+
+        int64_t rc = escapeDecode(in, len, *buffer);
+        if (rc >= 0) (*buffer)[rc] = 0;
+        return rc;
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef _DBICXX_PG_BYTEA_H
+#define _DBICXX_PG_BYTEA_H
+
+#include <stdint.h>
+
+// bytea decoding without libpq, kept free of dbic++ headers so it can be benchmarked on its own.
+namespace dbi {
+    // decodes len hex digits into out, which must hold len/2 bytes. returns false on invalid input.
+    bool PQ_HEX_DECODE(const unsigned char *in, uint64_t len, unsigned char *out);
+
+    // decodes a bytea value in hex (\x...) or escape format into *buffer, growing it as needed.
+    // returns the decoded length or -1 on invalid input.
+    int64_t PQ_BYTEA_DECODE(const unsigned char *in, uint64_t len, unsigned char **buffer, uint64_t *size);
+}
+
+#endif
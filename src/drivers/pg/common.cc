@@ -36,19 +36,228 @@ namespace dbi {
         }
     }
 
-    void PQ_PROCESS_BIND(const char ***param_v, int **param_l, int **param_f, param_list_t &bind) {
-        *param_v = new const char*[bind.size()];
-        *param_l = new int[bind.size()];
-        *param_f = new int[bind.size()];
+    // types, when given, are the parameter types of a prepared statement and values the driver
+    // knows how to encode are sent in binary. everything else goes as text, typed by the server.
+    void PQ_PROCESS_BIND(PgParams &params, param_list_t &bind, const Oid *types) {
+        uint32_t i, size = bind.size();
+        vector<int> offsets(size, -1);
 
-        for (uint32_t i = 0; i < bind.size(); i++) {
+        params.values.resize(size);
+        params.lengths.resize(size);
+        params.formats.resize(size);
+        params.data.clear();
+
+        for (i = 0; i < size; i++) {
             bool isnull = bind[i].isnull;
-            (*param_v)[i] = isnull ? 0 : bind[i].value.data();
-            (*param_l)[i] = isnull ? 0 : bind[i].value.length();
-            (*param_f)[i] = bind[i].binary ? 1 : 0;
+            params.values[i]  = isnull ? 0 : bind[i].value.data();
+            params.lengths[i] = isnull ? 0 : bind[i].value.length();
+            params.formats[i] = bind[i].binary ? 1 : 0;
+
+            if (!types || isnull || bind[i].binary) continue;
+
+            int offset = params.data.size();
+            if (PQ_BINARY_PARAM(types[i], bind[i], params.data)) {
+                offsets[i]        = offset;
+                params.lengths[i] = params.data.size() - offset;
+                params.formats[i] = 1;
+            }
+        }
+
+        // data may have moved while it grew.
+        for (i = 0; i < size; i++)
+            if (offsets[i] >= 0) params.values[i] = params.data.data() + offsets[i];
+    }
+
+    static void PQ_PUT_INT(string &data, uint64_t value, int length) {
+        for (int shift = (length - 1) * 8; shift >= 0; shift -= 8)
+            data += (char)((value >> shift) & 0xff);
+    }
+
+    // days since 1970-01-01.
+    static int64_t PQ_CIVIL_DAYS(int y, int m, int d) {
+        y -= m <= 2 ? 1 : 0;
+        int64_t era  = (y >= 0 ? y : y - 399) / 400;
+        uint32_t yoe = (uint32_t)(y - era * 400);
+        uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + (int64_t)doe - 719468;
+    }
+
+    static int PQ_MONTH_DAYS(int y, int m) {
+        static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return m == 2 && y % 4 == 0 && (y % 100 != 0 || y % 400 == 0) ? 29 : days[m - 1];
+    }
+
+    // YYYY-MM-DD[ HH:MM:SS[.ffffff]][Z|+-HH[:MM]], anything else is left to the server.
+    static bool PQ_PARSE_TIMESTAMP(const char *s, Timestamp &t, bool &zoned) {
+        int n = 0, digits;
+        memset(&t, 0, sizeof(Timestamp));
+        zoned = false;
+
+        if (sscanf(s, "%4d-%2d-%2d%n", &t.year, &t.month, &t.day, &n) != 3) return false;
+        if (t.year < 1 || t.month < 1 || t.month > 12 || t.day < 1) return false;
+        if (t.day > PQ_MONTH_DAYS(t.year, t.month)) return false;
+        s += n;
+
+        if (*s == ' ' || *s == 'T') {
+            if (sscanf(s + 1, "%2d:%2d:%2d%n", &t.hour, &t.minute, &t.second, &n) != 3) return false;
+            if (t.hour > 24 || t.minute > 59 || t.second > 60) return false;
+            s += n + 1;
+
+            if (*s == '.') {
+                for (s++, digits = 0; *s >= '0' && *s <= '9'; s++, digits++)
+                    if (digits < 6) t.usec = t.usec * 10 + (*s - '0');
+                for (; digits < 6; digits++) t.usec *= 10;
+            }
+
+            if (*s == 'Z') {
+                zoned = true;
+                s++;
+            }
+            else if (*s == '+' || *s == '-') {
+                int sign = *s == '-' ? -1 : 1, hours = 0, minutes = 0;
+                if (sscanf(s + 1, "%2d%n", &hours, &n) != 1) return false;
+                s += n + 1;
+                if (*s == ':') s++;
+                if (*s >= '0' && *s <= '9') {
+                    if (sscanf(s, "%2d%n", &minutes, &n) != 1) return false;
+                    s += n;
+                }
+                t.tzoffset = sign * (hours * 3600 + minutes * 60);
+                zoned = true;
+            }
+        }
+
+        return *s == 0;
+    }
+
+    // the spellings boolin() accepts in full, returns -1 for anything else.
+    static int PQ_PARSE_BOOL(const char *value) {
+        static const char *truths[] = {"t", "true", "y", "yes", "on", "1", 0};
+        static const char *lies[]   = {"f", "false", "n", "no", "off", "0", 0};
+
+        for (int i = 0; truths[i]; i++)
+            if (strcasecmp(value, truths[i]) == 0) return 1;
+        for (int i = 0; lies[i]; i++)
+            if (strcasecmp(value, lies[i]) == 0) return 0;
+        return -1;
+    }
+
+    // encodes a parameter in network byte order, returns false if it needs to go as text.
+    bool PQ_BINARY_PARAM(Oid type, Param &param, string &data) {
+        char *end;
+        bool zoned;
+        Timestamp t;
+        const char *value = param.value.c_str();
+
+        if (param.value.empty()) return false;
+
+        switch (type) {
+            case 16: {
+                int v = PQ_PARSE_BOOL(value);
+                if (v < 0) return false;
+                data += (char)v;
+                return true;
+            }
+            case 20: case 21: case 23: {
+                errno = 0;
+                long long v = strtoll(value, &end, 10);
+                if (*end || errno) return false;
+                if (type == 21 && (v < -32768 || v > 32767)) return false;
+                if (type == 23 && (v < -2147483647LL - 1 || v > 2147483647LL)) return false;
+                PQ_PUT_INT(data, (uint64_t)v, type == 20 ? 8 : type == 23 ? 4 : 2);
+                return true;
+            }
+            case 700: case 701: {
+                double v = strtod(value, &end);
+                if (*end) return false;
+                if (type == 700) {
+                    uint32_t bits;
+                    float f = (float)v;
+                    memcpy(&bits, &f, 4);
+                    PQ_PUT_INT(data, bits, 4);
+                }
+                else {
+                    uint64_t bits;
+                    memcpy(&bits, &v, 8);
+                    PQ_PUT_INT(data, bits, 8);
+                }
+                return true;
+            }
+            case 1082:
+                if (!PQ_PARSE_TIMESTAMP(value, t, zoned) || t.hour || t.minute || t.second) return false;
+                PQ_PUT_INT(data, (uint64_t)(PQ_CIVIL_DAYS(t.year, t.month, t.day) - 10957), 4);
+                return true;
+            case 1114: case 1184: {
+                // without an explicit zone the server would apply the session time zone.
+                if (!PQ_PARSE_TIMESTAMP(value, t, zoned) || (type == 1184 && !zoned)) return false;
+                int64_t usecs = (PQ_CIVIL_DAYS(t.year, t.month, t.day) - 10957) * 86400000000LL +
+                                (t.hour * 3600LL + t.minute * 60 + t.second) * 1000000LL + t.usec;
+                if (type == 1184) usecs -= t.tzoffset * 1000000LL;
+                PQ_PUT_INT(data, (uint64_t)usecs, 8);
+                return true;
+            }
+            default:
+                return false;
         }
     }
 
+    // column types PQ_COPY_BINARY_FIELD can encode, tables with any other go through text COPY.
+    bool PQ_COPY_BINARY_TYPE(Oid type) {
+        switch (type) {
+            case   16: case   17: case   18: case   19: case   20: case   21: case   23: case  25:
+            case  114: case  700: case  701: case 1042: case 1043: case 1082: case 1114: case 1184:
+            case 2950:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // appends a length prefixed COPY BINARY field, values of text like types go as is.
+    bool PQ_COPY_BINARY_FIELD(Oid type, Param &param, string &data) {
+        uint64_t offset = data.length();
+
+        if (param.isnull) {
+            PQ_PUT_INT(data, 0xffffffff, 4);
+            return true;
+        }
+
+        PQ_PUT_INT(data, 0, 4);
+        switch (type) {
+            case 17: case 18: case 19: case 25: case 114: case 1042: case 1043:
+                data += param.value;
+                break;
+            case 2950: {
+                unsigned char hex[32], uuid[16];
+                int n = 0;
+                for (uint64_t i = 0; i < param.value.length(); i++) {
+                    char c = param.value[i];
+                    if (c == '-' || c == '{' || c == '}') continue;
+                    if (n == 32) { n = 0; break; }
+                    hex[n++] = c;
+                }
+                if (n != 32 || !PQ_HEX_DECODE(hex, 32, uuid)) {
+                    data.resize(offset);
+                    return false;
+                }
+                data.append((char*)uuid, 16);
+                break;
+            }
+            default:
+                if (!PQ_BINARY_PARAM(type, param, data)) {
+                    data.resize(offset);
+                    return false;
+                }
+        }
+
+        uint32_t length = data.length() - offset - 4;
+        for (int n = 0; n < 4; n++)
+            data[offset + n] = (char)((length >> (24 - n * 8)) & 0xff);
+
+        return true;
+    }
+
     void PQ_CHECK_RESULT(PGresult **result, PGconn *conn, string sql) {
         bool cerror;
         switch(PQresultStatus(*result)) {
@@ -82,6 +291,197 @@ namespace dbi {
                 break;
         }
     }
+
+    // waits for the socket of a non-blocking connection to drain, consuming any input that
+    // arrives meanwhile so the server never stalls on a full send buffer (see PQflush docs).
+    void PQ_WAIT(PGconn *conn) {
+        struct pollfd fd;
+        fd.fd     = PQsocket(conn);
+        fd.events = POLLIN | POLLOUT;
+
+        while (poll(&fd, 1, -1) < 0) {
+            if (errno != EINTR)
+                throw RuntimeError(strerror(errno));
+        }
+
+        if ((fd.revents & POLLIN) && !PQconsumeInput(conn))
+            throw RuntimeError(PQerrorMessage(conn));
+    }
+
+    // PQexec and friends, split into send, wait and fetch when phase timing is on.
+    PGresult* PQ_EXEC(PGconn *conn, const char *sql) {
+        if (!_phase_timing) return PQexec(conn, sql);
+        return PQ_TIMED_RESULT(conn, PQsendQuery(conn, sql));
+    }
+
+    PGresult* PQ_EXEC_PARAMS(PGconn *conn, const char *sql, PgParams &params, int nparams) {
+        const char **values = nparams > 0 ? (const char **)&params.values[0] : 0;
+        const int  *lengths = nparams > 0 ? &params.lengths[0] : 0;
+        const int  *formats = nparams > 0 ? &params.formats[0] : 0;
+
+        if (!_phase_timing) return PQexecParams(conn, sql, nparams, 0, values, lengths, formats, 0);
+        return PQ_TIMED_RESULT(conn, PQsendQueryParams(conn, sql, nparams, 0, values, lengths, formats, 0));
+    }
+
+    PGresult* PQ_EXEC_PREPARED(PGconn *conn, const char *name, PgParams &params, int nparams, int format) {
+        const char **values = nparams > 0 ? (const char **)&params.values[0] : 0;
+        const int  *lengths = nparams > 0 ? &params.lengths[0] : 0;
+        const int  *formats = nparams > 0 ? &params.formats[0] : 0;
+
+        if (!_phase_timing) return PQexecPrepared(conn, name, nparams, values, lengths, formats, format);
+        return PQ_TIMED_RESULT(conn, PQsendQueryPrepared(conn, name, nparams, values, lengths, formats, format));
+    }
+
+    // collects results the way PQexec does, keeping the last one. the first bytes of the response
+    // end the wait phase, reading and parsing the rest of it is the fetch phase.
+    PGresult* PQ_TIMED_RESULT(PGconn *conn, int sent) {
+        PGresult *result = 0, *next;
+        struct pollfd fd;
+
+        if (!sent) return PQmakeEmptyPGresult(conn, PGRES_FATAL_ERROR);
+        phaseLap(DBI_PHASE_SEND);
+
+        fd.fd     = PQsocket(conn);
+        fd.events = POLLIN;
+        while (poll(&fd, 1, -1) < 0 && errno == EINTR);
+        phaseLap(DBI_PHASE_WAIT);
+
+        while ((next = PQgetResult(conn))) {
+            if (result) PQclear(result);
+            result = next;
+
+            ExecStatusType status = PQresultStatus(result);
+            if (status == PGRES_COPY_IN || status == PGRES_COPY_OUT || status == PGRES_COPY_BOTH)
+                break;
+        }
+
+        phaseLap(DBI_PHASE_FETCH);
+        return result ? result : PQmakeEmptyPGresult(conn, PGRES_FATAL_ERROR);
+    }
+
+    // queues a chunk of COPY data on a non-blocking connection. PQputCopyData() grows the output
+    // buffer instead of pushing back, so the previous chunk is drained first and at most one chunk
+    // is in flight while the caller prepares the next.
+    void PQ_PUT_COPY_DATA(PGconn *conn, const char *data, uint64_t len) {
+        int rc;
+
+        PQ_FLUSH(conn, true);
+        while ((rc = PQputCopyData(conn, data, len)) == 0)
+            PQ_WAIT(conn);
+        if (rc < 0)
+            throw RuntimeError(PQerrorMessage(conn));
+
+        PQ_FLUSH(conn, false);
+    }
+
+    // pushes queued output to the server, when wait is false this returns as soon as the
+    // socket would block and the remainder goes out with later calls.
+    void PQ_FLUSH(PGconn *conn, bool wait) {
+        int rc;
+        while ((rc = PQflush(conn)) == 1 && wait)
+            PQ_WAIT(conn);
+        if (rc < 0)
+            throw RuntimeError(PQerrorMessage(conn));
+    }
+
+    // result columns of these types are decoded from binary format, see PgResult::decode().
+    // timestamptz stays in text so the server renders it in the session time zone.
+    bool PQ_BINARY_RESULTS(PGresult *description, PGconn *conn) {
+        const char *integer_datetimes = PQparameterStatus(conn, "integer_datetimes");
+        bool datetimes = integer_datetimes && strcmp(integer_datetimes, "on") == 0;
+
+        if (PQnfields(description) < 1) return false;
+
+        for (int i = 0; i < PQnfields(description); i++) {
+            switch(PQftype(description, i)) {
+                case   16: case   17: case   19: case   20: case   21: case   23: case   25: case   26:
+                case  114: case  700: case  701: case 1042: case 1043: case 1082: case 2950:
+                    break;
+                case 1083: case 1114:
+                    if (!datetimes) return false;
+                    break;
+                default:
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    // network byte order, sign extended to the width of the field.
+    int64_t PQ_BINARY_INT(const unsigned char *data, int length) {
+        uint64_t value = 0;
+        for (int i = 0; i < length; i++) value = (value << 8) | data[i];
+
+        switch (length) {
+            case 1:  return (int8_t)value;
+            case 2:  return (int16_t)value;
+            case 4:  return (int32_t)value;
+            default: return (int64_t)value;
+        }
+    }
+
+    double PQ_BINARY_FLOAT(const unsigned char *data, int length) {
+        if (length == 4) {
+            float f;
+            uint32_t bits = (uint32_t)PQ_BINARY_INT(data, 4);
+            memcpy(&f, &bits, 4);
+            return f;
+        }
+        else {
+            double d;
+            uint64_t bits = (uint64_t)PQ_BINARY_INT(data, 8);
+            memcpy(&d, &bits, 8);
+            return d;
+        }
+    }
+
+    // days since 2000-01-01 to a calendar date.
+    void PQ_BINARY_DATE(int32_t days, Timestamp &t) {
+        int64_t z = (int64_t)days + 10957 + 719468;
+        int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        uint32_t doe = (uint32_t)(z - era * 146097);
+        uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        uint32_t mp  = (5 * doy + 2) / 153;
+
+        memset(&t, 0, sizeof(Timestamp));
+        t.day   = doy - (153 * mp + 2) / 5 + 1;
+        t.month = mp < 10 ? mp + 3 : mp - 9;
+        t.year  = (int)(yoe + era * 400) + (t.month <= 2 ? 1 : 0);
+    }
+
+    // microseconds since 2000-01-01 00:00:00 (integer_datetimes).
+    void PQ_BINARY_TIMESTAMP(int64_t usecs, Timestamp &t) {
+        const int64_t day = 86400000000LL;
+        int64_t days = usecs / day, rem = usecs % day;
+
+        if (rem < 0) {
+            rem += day;
+            days--;
+        }
+
+        PQ_BINARY_DATE((int32_t)days, t);
+        t.hour   = (int)(rem / 3600000000LL);
+        t.minute = (int)(rem / 60000000LL % 60);
+        t.second = (int)(rem / 1000000LL % 60);
+        t.usec   = (int)(rem % 1000000LL);
+    }
+
+    uint64_t PQ_LAST_INSERT_ID(PGresult *result) {
+        if (PQntuples(result) < 1 || PQnfields(result) < 1 || PQgetisnull(result, 0, 0)) return 0;
+
+        if (PQfformat(result, 0) == 1) {
+            switch (PQftype(result, 0)) {
+                case 20: case 21: case 23: case 26:
+                    return (uint64_t)PQ_BINARY_INT((unsigned char*)PQgetvalue(result, 0, 0), PQgetlength(result, 0, 0));
+                default:
+                    return 0;
+            }
+        }
+
+        return atol(PQgetvalue(result, 0, 0));
+    }
 }
 
 using namespace std;
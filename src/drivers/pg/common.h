@@ -9,6 +9,8 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <poll.h>
+#include "bytea.h"
 
 #define DRIVER_NAME     "postgresql"
 #define DRIVER_VERSION  "1.3"
@@ -16,12 +18,37 @@
 #define PG2PARAM(res, r, c) PARAM((unsigned char*)PQgetvalue(res, r, c), PQgetlength(res, r, c))
 
 namespace dbi {
+    // bind arrays handed to libpq, kept around so they can be reused across executions.
+    struct PgParams {
+        vector<const char*> values;
+        vector<int>         lengths, formats;
+        string              data;
+    };
+
     extern char errormsg[8192];
     extern const char *typemap[];
     void PQ_NOTICE(void *arg, const char *message);
     void PQ_PREPROCESS_QUERY(string &query);
-    void PQ_PROCESS_BIND(const char ***param_v, int **param_l, int **param_f, param_list_t &bind);
+    void PQ_PROCESS_BIND(PgParams &params, param_list_t &bind, const Oid *types);
+    bool PQ_BINARY_PARAM(Oid type, Param &param, string &data);
+    bool PQ_COPY_BINARY_TYPE(Oid type);
+    bool PQ_COPY_BINARY_FIELD(Oid type, Param &param, string &data);
     void PQ_CHECK_RESULT(PGresult **result, PGconn *conn, string sql);
+    void PQ_WAIT(PGconn *conn);
+    void PQ_PUT_COPY_DATA(PGconn *conn, const char *data, uint64_t len);
+    void PQ_FLUSH(PGconn *conn, bool wait);
+
+    PGresult* PQ_EXEC(PGconn *conn, const char *sql);
+    PGresult* PQ_EXEC_PARAMS(PGconn *conn, const char *sql, PgParams &params, int nparams);
+    PGresult* PQ_EXEC_PREPARED(PGconn *conn, const char *name, PgParams &params, int nparams, int format);
+    PGresult* PQ_TIMED_RESULT(PGconn *conn, int sent);
+
+    bool     PQ_BINARY_RESULTS(PGresult *description, PGconn *conn);
+    int64_t  PQ_BINARY_INT(const unsigned char *data, int length);
+    double   PQ_BINARY_FLOAT(const unsigned char *data, int length);
+    void     PQ_BINARY_DATE(int32_t days, Timestamp &t);
+    void     PQ_BINARY_TIMESTAMP(int64_t usecs, Timestamp &t);
+    uint64_t PQ_LAST_INSERT_ID(PGresult *result);
 }
 
 #include "result.h"
@@ -3,9 +3,12 @@
 namespace dbi {
 
     PgHandle::PgHandle() {
-        tr_nesting = 0;
-        _result    = 0;
-        conn       = 0;
+        tr_nesting      = 0;
+        _result         = 0;
+        _binary_results = false;
+        _binary_params  = false;
+        _copy_buffer    = 0;
+        conn            = 0;
     }
 
     string PgHandle::parseOptions(char *options) {
@@ -16,7 +19,13 @@ namespace dbi {
         string value;
         string extra;
         while (re.FindAndConsume(&input, &option, &value)) {
-            extra += " " + option + "='" + escaped(value) + "'";
+            // driver settings, everything else goes to libpq.
+            if (option == "binary_results")
+                binaryResults(value == "1" || value == "true");
+            else if (option == "binary_params")
+                binaryParams(value == "1" || value == "true");
+            else
+                extra += " " + option + "='" + escaped(value) + "'";
         }
 
         return extra;
@@ -30,9 +39,12 @@ namespace dbi {
     }
 
     PgHandle::PgHandle(string user, string pass, string dbname, string host, string port, char *options) {
-        tr_nesting = 0;
-        _result    = 0;
-        conn       = 0;
+        tr_nesting      = 0;
+        _result         = 0;
+        _binary_results = false;
+        _binary_params  = false;
+        _copy_buffer    = 0;
+        conn            = 0;
 
         char conninfo[4096];
         snprintf(conninfo, 1024, "dbname='%s' user='%s' password='%s' host='%s' port='%s' sslmode='allow'",
@@ -75,6 +87,9 @@ namespace dbi {
         if (_result) PQclear(_result);
         if (conn)    PQfinish(conn);
 
+        delete [] _copy_buffer;
+        _copy_buffer = 0;
+
         _result = 0;
         conn    = 0;
     }
@@ -104,7 +119,7 @@ namespace dbi {
         _sql = sql;
 
         // no need to pre-process sql without arguments
-        result = PQexec(conn, normalized_sql.c_str());
+        result = PQ_EXEC(conn, normalized_sql.c_str());
         PQ_CHECK_RESULT(&result, conn, sql);
 
         if (_result) PQclear(_result);
@@ -112,35 +127,17 @@ namespace dbi {
     }
 
     PGresult* PgHandle::_pgexec(string sql, param_list_t &bind) {
-        int *param_l, *param_f;
-        const char **param_v;
         PGresult *result;
         string normalized_sql = sql;
         _sql = sql;
 
         PQ_PREPROCESS_QUERY(normalized_sql);
-        PQ_PROCESS_BIND(&param_v, &param_l, &param_f, bind);
-        try {
-            result = PQexecParams(conn, normalized_sql.c_str(), bind.size(), 0,
-                                        (const char* const *)param_v, param_l, param_f, 0);
-            PQ_CHECK_RESULT(&result, conn, sql);
-        }
-        catch (ConnectionError &e) {
-            delete []param_v;
-            delete []param_l;
-            delete []param_f;
-            throw e;
-        }
-        catch (Error &e) {
-            delete []param_v;
-            delete []param_l;
-            delete []param_f;
-            throw e;
-        }
+        phaseLap(DBI_PHASE_PREPROCESS);
+        PQ_PROCESS_BIND(_params, bind, 0);
+        phaseLap(DBI_PHASE_BIND);
 
-        delete []param_v;
-        delete []param_l;
-        delete []param_f;
+        result = PQ_EXEC_PARAMS(conn, normalized_sql.c_str(), _params, bind.size());
+        PQ_CHECK_RESULT(&result, conn, sql);
 
         if (_result) PQclear(_result);
         return _result = result;
@@ -180,18 +177,15 @@ namespace dbi {
     }
 
     PgResult* PgHandle::aexecute(string sql, param_list_t &bind) {
-        int *param_l, *param_f;
-        const char **param_v;
         string normalized_sql = sql;
         PQ_PREPROCESS_QUERY(normalized_sql);
-        PQ_PROCESS_BIND(&param_v, &param_l, &param_f, bind);
+        PQ_PROCESS_BIND(_params, bind, 0);
         async(true);
-        int done = PQsendQueryParams(conn, normalized_sql.c_str(), bind.size(),
-                                     0, (const char* const *)param_v, param_l, param_f, 0);
+        int done = PQsendQueryParams(conn, normalized_sql.c_str(), bind.size(), 0,
+                                     bind.size() > 0 ? &_params.values[0]  : 0,
+                                     bind.size() > 0 ? &_params.lengths[0] : 0,
+                                     bind.size() > 0 ? &_params.formats[0] : 0, 0);
 
-        delete []param_v;
-        delete []param_l;
-        delete []param_f;
         if (!done) boom(PQerrorMessage(conn));
         return new PgResult(0, sql, conn);
     }
@@ -217,7 +211,7 @@ namespace dbi {
 
     PgStatement* PgHandle::prepare(string sql) {
         async(false);
-        return new PgStatement(sql, &conn);
+        return new PgStatement(sql, &conn, _binary_results, _binary_params);
     }
 
     bool PgHandle::begin() {
@@ -285,6 +279,7 @@ namespace dbi {
                 PQfinish(conn);
                 conn = PQconnectdb(conninfo);
                 if (PQstatus(conn) == CONNECTION_BAD) throw ConnectionError(PQerrorMessage(conn));
+                metrics::add(DBI_METRIC_RECONNECTS);
                 sprintf(errormsg, "NOTICE: Socket changed during auto reconnect to database %s on host %s\n",
                     PQdb(conn), PQhost(conn));
                 if (_trace)
@@ -293,6 +288,7 @@ namespace dbi {
             else throw ConnectionError(PQerrorMessage(conn));
         }
         else {
+            metrics::add(DBI_METRIC_RECONNECTS);
             sprintf(errormsg, "NOTICE: Auto reconnected on same socket to database %s on host %s\n",
                 PQdb(conn), PQhost(conn));
             if (_trace)
@@ -308,30 +304,262 @@ namespace dbi {
     }
 
     uint64_t PgHandle::write(string table, field_list_t &fields, IO* io) {
-        char sql[4096], *buffer;
-        uint64_t nrows, len, buffer_len = 1024*1024;
+        char sql[4096];
 
         if (fields.size() > 0)
             snprintf(sql, 4095, "copy %s (%s) from stdin", table.c_str(), fields.join(", ").c_str());
         else
             snprintf(sql, 4095, "copy %s from stdin", table.c_str());
 
+        _copyBegin(sql);
+        try {
+            _copyIn(io);
+            _copyFinish();
+        }
+        catch (...) {
+            _copyAbort();
+            throw;
+        }
+
+        return _copyResult(sql);
+    }
+
+    uint64_t PgHandle::write(string table, field_list_t &fields, row_list_t &rows) {
+        RowList source(rows);
+        return writeRows(table, fields, source);
+    }
+
+    uint64_t PgHandle::writeRows(string table, field_list_t &fields, RowSource &source) {
+        char sql[4096];
+
+        // column types decide how each value is encoded.
+        snprintf(sql, 4095, "select %s from %s limit 0",
+            fields.size() > 0 ? fields.join(", ").c_str() : "*", table.c_str());
+
+        PGresult *description = PQexec(conn, sql);
+        PQ_CHECK_RESULT(&description, conn, sql);
+
+        // types without a binary encoder (numeric, interval, arrays ...) are left to the server.
+        bool binary = true;
+        for (int c = 0; c < PQnfields(description); c++)
+            binary = binary && PQ_COPY_BINARY_TYPE(PQftype(description, c));
+
+        if (fields.size() > 0)
+            snprintf(sql, 4095, "copy %s (%s) from stdin%s", table.c_str(), fields.join(", ").c_str(),
+                binary ? " with binary" : "");
+        else
+            snprintf(sql, 4095, "copy %s from stdin%s", table.c_str(), binary ? " with binary" : "");
+
+        try {
+            _copyBegin(sql);
+            try {
+                if (binary)
+                    _copyRows(description, source);
+                else
+                    _copyText(description, source);
+                _copyFinish();
+            }
+            catch (...) {
+                _copyAbort();
+                throw;
+            }
+        }
+        catch (...) {
+            PQclear(description);
+            throw;
+        }
+
+        PQclear(description);
+        return _copyResult(sql);
+    }
+
+    uint64_t PgHandle::read(string source, field_list_t &fields, IO* io) {
+        int len;
+        char *buffer;
+        string sql;
+
+        if (isQuery(source))
+            sql = "copy (" + source + ") to stdout";
+        else if (fields.size() > 0)
+            sql = "copy " + source + " (" + fields.join(", ") + ") to stdout";
+        else
+            sql = "copy " + source + " to stdout";
+
         if (_trace)
             logMessage(_trace_fd, sql);
 
         _pgexecDirect(sql);
 
-        buffer = new char[buffer_len];
-        while ((len = io->read(buffer, buffer_len)) > 0) {
-            if (PQputCopyData(conn, buffer, len) != 1) {
-                delete [] buffer;
-                throw RuntimeError(PQerrorMessage(conn));
+        // each chunk is a complete row in COPY text format.
+        try {
+            while ((len = PQgetCopyData(conn, &buffer, 0)) > 0) {
+                io->write(buffer, len);
+                PQfreemem(buffer);
             }
         }
+        catch (...) {
+            PQfreemem(buffer);
+            PQrequestCancel(conn);
+            while ((len = PQgetCopyData(conn, &buffer, 0)) > 0) PQfreemem(buffer);
+
+            PGresult *res;
+            while ((res = PQgetResult(conn))) PQclear(res);
+            throw;
+        }
 
-        delete [] buffer;
-        if (PQputCopyEnd(conn, 0) != 1)
-                throw RuntimeError(PQerrorMessage(conn));
+        if (len == -2)
+            throw RuntimeError(PQerrorMessage(conn));
+
+        return _copyResult(sql.c_str());
+    }
+
+    void PgHandle::_copyBegin(const char *sql) {
+        if (_trace)
+            logMessage(_trace_fd, sql);
+
+        _pgexecDirect(sql);
+
+        // the copy runs on a non-blocking connection so that filling the next chunk
+        // overlaps with libpq pushing the previous one onto the socket, see PQ_PUT_COPY_DATA.
+        if (PQsetnonblocking(conn, 1) != 0)
+            throw RuntimeError(PQerrorMessage(conn));
+    }
+
+    void PgHandle::_copyFinish() {
+        int rc;
+        while ((rc = PQputCopyEnd(conn, 0)) == 0)
+            PQ_WAIT(conn);
+        if (rc < 0)
+            throw RuntimeError(PQerrorMessage(conn));
+
+        PQ_FLUSH(conn, true);
+    }
+
+    // called from catch blocks, so it never throws and the original error goes up. if the
+    // abort cannot reach the server the connection is broken and later queries report it.
+    void PgHandle::_copyAbort() {
+        int rc;
+        try {
+            while ((rc = PQputCopyEnd(conn, "dbic++: copy aborted")) == 0)
+                PQ_WAIT(conn);
+            // libpq flushes on leaving non-blocking mode and fails if that would block.
+            if (rc > 0) PQ_FLUSH(conn, true);
+        }
+        catch (...) {
+        }
+
+        if (PQsetnonblocking(conn, 0) != 0) return;
+
+        // a copy the server has not ended keeps handing out COPY_IN results.
+        PGresult *res;
+        while ((res = PQgetResult(conn))) {
+            ExecStatusType status = PQresultStatus(res);
+            PQclear(res);
+            if (status == PGRES_COPY_IN || status == PGRES_COPY_OUT) break;
+        }
+    }
+
+    void PgHandle::_copyIn(IO *io) {
+        const char *chunk;
+        uint64_t len, size = 1024*1024;
+
+        // io objects with zero copy reads hand out their own storage.
+        if ((len = io->read(&chunk, size)) > 0) {
+            do {
+                PQ_PUT_COPY_DATA(conn, chunk, len);
+            } while ((len = io->read(&chunk, size)) > 0);
+        }
+        // libpq copies the data it queues, so a single buffer can be refilled right away.
+        else {
+            if (!_copy_buffer) _copy_buffer = new char[size];
+
+            while ((len = io->read(_copy_buffer, size)) > 0)
+                PQ_PUT_COPY_DATA(conn, _copy_buffer, len);
+        }
+    }
+
+    // write only io object feeding COPY IN, see _copyText().
+    class PgCopyIO : public IO {
+        protected:
+        PGconn *conn;
+        string empty;
+
+        public:
+        PgCopyIO(PGconn *c) : conn(c) {}
+
+        void write(const char *data, uint64_t len) { PQ_PUT_COPY_DATA(conn, data, len); }
+        void write(const char *data)               { write(data, strlen(data)); }
+
+        string&  read()                  { return empty; }
+        uint32_t read(char *, uint32_t)  { return 0; }
+        bool     readline(string &)      { return false; }
+        char*    readline()              { return 0; }
+        void     truncate()              {}
+    };
+
+    // COPY text stream, used when a column has no binary encoder.
+    void PgHandle::_copyText(PGresult *description, RowSource &source) {
+        ResultRow *next;
+        uint64_t r  = 0;
+        int columns = PQnfields(description);
+
+        PgCopyIO io(conn);
+        TsvWriter tsv(&io);
+
+        for (; (next = source.next()); r++) {
+            if (next->size() != columns) {
+                snprintf(errormsg, 8192, "Row %lu has %d values, expected %d", (unsigned long)r, next->size(), columns);
+                throw RuntimeError(errormsg);
+            }
+            tsv.write(*next);
+        }
+
+        tsv.flush();
+    }
+
+    // COPY BINARY stream: signature, flags and header extension length, then per row a
+    // field count followed by length prefixed values, terminated by a -1 field count.
+    void PgHandle::_copyRows(PGresult *description, RowSource &source) {
+        ResultRow *next;
+        uint64_t r     = 0;
+        uint64_t size  = 1024*1024;
+        int columns    = PQnfields(description);
+        string &data   = _copy_data;
+
+        data.assign("PGCOPY\n\377\r\n\0\0\0\0\0\0\0\0\0", 19);
+
+        for (; (next = source.next()); r++) {
+            ResultRow &row = *next;
+            if (row.size() != columns) {
+                snprintf(errormsg, 8192, "Row %lu has %d values, expected %d", (unsigned long)r, row.size(), columns);
+                throw RuntimeError(errormsg);
+            }
+
+            data += (char)(columns >> 8);
+            data += (char)(columns & 0xff);
+            for (int c = 0; c < columns; c++) {
+                if (!PQ_COPY_BINARY_FIELD(PQftype(description, c), row[c], data)) {
+                    snprintf(errormsg, 8192, "Row %lu: invalid value for column %s in binary copy",
+                        (unsigned long)r, PQfname(description, c));
+                    throw RuntimeError(errormsg);
+                }
+            }
+
+            if (data.length() >= size) {
+                PQ_PUT_COPY_DATA(conn, data.data(), data.length());
+                data.clear();
+            }
+        }
+
+        data += "\377\377";
+        PQ_PUT_COPY_DATA(conn, data.data(), data.length());
+        data.clear();
+    }
+
+    uint64_t PgHandle::_copyResult(const char *sql) {
+        uint64_t nrows;
+        if (PQsetnonblocking(conn, 0) != 0)
+            throw RuntimeError(PQerrorMessage(conn));
 
         PGresult *res = PQgetResult(conn);
         PQ_CHECK_RESULT(&res, conn, sql);
@@ -354,6 +582,14 @@ namespace dbi {
         return escaped;
     }
 
+    void PgHandle::binaryResults(bool flag) {
+        _binary_results = flag;
+    }
+
+    void PgHandle::binaryParams(bool flag) {
+        _binary_params = flag;
+    }
+
     string PgHandle::driver() {
         return DRIVER_NAME;
     }
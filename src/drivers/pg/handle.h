@@ -14,6 +14,19 @@ namespace dbi {
 
         PGresult *_result;
         string _connextra;
+        bool _binary_results, _binary_params;
+        PgParams _params;
+
+        // COPY IN, see write().
+        char *_copy_buffer;
+        string _copy_data;
+        void _copyBegin(const char *sql);
+        void _copyIn(IO *);
+        void _copyRows(PGresult *description, RowSource &source);
+        void _copyText(PGresult *description, RowSource &source);
+        void _copyFinish();
+        void _copyAbort();
+        uint64_t _copyResult(const char *sql);
 
         protected:
         int tr_nesting;
@@ -53,10 +66,16 @@ namespace dbi {
         void reconnect();
 
         uint64_t write(string table, field_list_t &fields, IO*);
+        uint64_t write(string table, field_list_t &fields, row_list_t &rows);
+        uint64_t writeRows(string table, field_list_t &fields, RowSource &source);
+        uint64_t read(string table_or_query, field_list_t &fields, IO*);
         void setTimeZoneOffset(int, int);
         void setTimeZone(char *);
         string escape(string);
         string driver();
+
+        void binaryResults(bool);
+        void binaryParams(bool);
     };
 }
 
@@ -1,4 +1,9 @@
 #include "common.h"
+#include <float.h>
+
+// binary date and timestamp values pg uses for +/-infinity.
+#define PQ_DATE_INFINITY      0x7FFFFFFF
+#define PQ_TIMESTAMP_INFINITY 0x7FFFFFFFFFFFFFFFLL
 
 namespace dbi {
     void PgResult::init() {
@@ -7,6 +12,7 @@ namespace dbi {
         _rows          = 0;
         _cols          = 0;
         _bytea         = 0;
+        _bytea_size    = 0;
         _affected_rows = 0;
     }
 
@@ -39,7 +45,8 @@ namespace dbi {
                 case   17: _rstypes.push_back(DBI_TYPE_BLOB); break;
                 case   20:
                 case   21:
-                case   23: _rstypes.push_back(DBI_TYPE_INT); break;
+                case   23:
+                case   26: _rstypes.push_back(DBI_TYPE_INT); break;
                 case   25: _rstypes.push_back(DBI_TYPE_TEXT); break;
                 case  700:
                 case  701: _rstypes.push_back(DBI_TYPE_FLOAT); break;
@@ -73,17 +80,181 @@ namespace dbi {
     }
 
     uint64_t PgResult::lastInsertID() {
-        return PQgetisnull(_result, 0, 0) ? 0 : atol(PQgetvalue(_result, 0, 0));
+        return PQ_LAST_INSERT_ID(_result);
     }
 
+    // decoded into a buffer reused across reads, valid until the next bytea is read.
     unsigned char* PgResult::unescapeBytea(int r, int c, uint64_t *l) {
-        size_t len;
-        if (_bytea) PQfreemem(_bytea);
-        _bytea = PQunescapeBytea((unsigned char *)PQgetvalue(_result, r, c), &len);
-        *l = (uint64_t)len;
+        int64_t len = PQ_BYTEA_DECODE((unsigned char *)PQgetvalue(_result, r, c), PQgetlength(_result, r, c),
+                                      &_bytea, &_bytea_size);
+        if (len < 0) {
+            snprintf(errormsg, 8192, "In SQL: %s\n\n Invalid bytea value in column %s", _sql.c_str(), PQfname(_result, c));
+            boom(errormsg);
+        }
+
+        if (l) *l = (uint64_t)len;
         return _bytea;
     }
 
+    // field value as text, bytea unescaped.
+    unsigned char* PgResult::field(int r, int c, uint64_t *l) {
+        if (PQfformat(_result, c) == 1)
+            return format(r, c, l);
+        if (_rstypes[c] == DBI_TYPE_BLOB)
+            return unescapeBytea(r, c, l);
+
+        if (l) *l = PQgetlength(_result, r, c);
+        return (unsigned char*)PQgetvalue(_result, r, c);
+    }
+
+    // shortest text that reads back as the same float4/float8, fixed point for decimal
+    // exponents from -4 up to 6 (float4) or 15 (float8), as the server prints them since 12.
+    static int PQ_FORMAT_FLOAT(double f, bool single, char *buffer, size_t size) {
+        char digits[64];
+        int precision, exponent, limit = single ? 9 : 17;
+
+        if (f != f)
+            return snprintf(buffer, size, "NaN");
+        if (f > DBL_MAX || f < -DBL_MAX)
+            return snprintf(buffer, size, f > 0 ? "Infinity" : "-Infinity");
+
+        for (precision = 1; precision < limit; precision++) {
+            snprintf(digits, sizeof(digits), "%.*e", precision - 1, f);
+            if (single ? (float)strtod(digits, 0) == (float)f : strtod(digits, 0) == f)
+                break;
+        }
+
+        snprintf(digits, sizeof(digits), "%.*e", precision - 1, f);
+        exponent = atoi(strchr(digits, 'e') + 1);
+
+        if (exponent < -4 || exponent >= (single ? 6 : 15))
+            return snprintf(buffer, size, "%s", digits);
+        return snprintf(buffer, size, "%.*f", precision - 1 > exponent ? precision - 1 - exponent : 0, f);
+    }
+
+    // date, time or timestamp as the server prints it with the ISO datestyle, fraction without
+    // trailing zeros and years before 1 AD as BC.
+    static int PQ_FORMAT_TIMESTAMP(Timestamp &t, int type, char *buffer, size_t size) {
+        int n = 0, digits = 6, usec = t.usec;
+        int year = t.year > 0 ? t.year : 1 - t.year;
+
+        if (type != DBI_TYPE_TIME)
+            n = snprintf(buffer, size, "%04d-%02d-%02d", year, t.month, t.day);
+        if (type != DBI_TYPE_DATE) {
+            n += snprintf(buffer + n, size - n, "%s%02d:%02d:%02d", n ? " " : "", t.hour, t.minute, t.second);
+            if (usec) {
+                while (usec % 10 == 0) {
+                    usec /= 10;
+                    digits--;
+                }
+                n += snprintf(buffer + n, size - n, ".%0*d", digits, usec);
+            }
+        }
+        if (type != DBI_TYPE_TIME && t.year <= 0)
+            n += snprintf(buffer + n, size - n, " BC");
+
+        return n;
+    }
+
+    // text form of a field sent in binary format, matches what the server would have sent as
+    // text with the default datestyle and extra_float_digits.
+    unsigned char* PgResult::format(int r, int c, uint64_t *l) {
+        Value v;
+        int n = 0;
+        unsigned char *data = (unsigned char*)PQgetvalue(_result, r, c);
+
+        switch (PQftype(_result, c)) {
+            case 16:
+                n = snprintf(_text, sizeof(_text), "%s", data[0] ? "t" : "f");
+                break;
+            case 20: case 21: case 23: case 26:
+                decode(r, c, v);
+                n = snprintf(_text, sizeof(_text), "%lld", (long long)v.i);
+                break;
+            case 700: case 701:
+                decode(r, c, v);
+                n = PQ_FORMAT_FLOAT(v.f, PQftype(_result, c) == 700, _text, sizeof(_text));
+                break;
+            case 1082: case 1083: case 1114:
+                decode(r, c, v);
+                // +/-infinity decodes to its text form.
+                n = v.data != data ? snprintf(_text, sizeof(_text), "%s", v.data) : PQ_FORMAT_TIMESTAMP(v.t, v.type, _text, sizeof(_text));
+                break;
+            case 2950:
+                n = snprintf(_text, sizeof(_text),
+                    "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+                    data[0], data[1], data[2],  data[3],  data[4],  data[5],  data[6],  data[7],
+                    data[8], data[9], data[10], data[11], data[12], data[13], data[14], data[15]);
+                break;
+            // bytea and the text types are sent as is.
+            default:
+                if (l) *l = PQgetlength(_result, r, c);
+                return data;
+        }
+
+        if (l) *l = n;
+        return (unsigned char*)_text;
+    }
+
+    // +/-infinity has no calendar value, it is left zeroed with data pointing to the text
+    // form the server sends, same as parseValue() does with text results.
+    static void PQ_INFINITY(bool positive, Value &v) {
+        static const char *infinity[] = {"-infinity", "infinity"};
+
+        memset(&v.t, 0, sizeof(Timestamp));
+        v.data   = (unsigned char*)infinity[positive];
+        v.length = strlen(infinity[positive]);
+    }
+
+    // native value of a field sent in binary format.
+    void PgResult::decode(int r, int c, Value &v) {
+        unsigned char *data = (unsigned char*)PQgetvalue(_result, r, c);
+        int length          = PQgetlength(_result, r, c);
+        int32_t days;
+        int64_t usecs;
+
+        v.type   = _rstypes[c];
+        v.isnull = false;
+        v.data   = data;
+        v.length = length;
+
+        switch (PQftype(_result, c)) {
+            case 16:
+                v.i = data[0] ? 1 : 0;
+                break;
+            case 20: case 21: case 23:
+                v.i = PQ_BINARY_INT(data, length);
+                break;
+            case 26:
+                v.i = (uint32_t)PQ_BINARY_INT(data, 4);
+                break;
+            case 700: case 701:
+                v.f = PQ_BINARY_FLOAT(data, length);
+                break;
+            case 1082:
+                days = (int32_t)PQ_BINARY_INT(data, 4);
+                if (days == PQ_DATE_INFINITY || days == -PQ_DATE_INFINITY - 1)
+                    PQ_INFINITY(days > 0, v);
+                else
+                    PQ_BINARY_DATE(days, v.t);
+                break;
+            case 1083:
+                PQ_BINARY_TIMESTAMP(PQ_BINARY_INT(data, 8), v.t);
+                v.t.year = v.t.month = v.t.day = 0;
+                break;
+            case 1114:
+                usecs = PQ_BINARY_INT(data, 8);
+                if (usecs == PQ_TIMESTAMP_INFINITY || usecs == -PQ_TIMESTAMP_INFINITY - 1)
+                    PQ_INFINITY(usecs > 0, v);
+                else
+                    PQ_BINARY_TIMESTAMP(usecs, v.t);
+                break;
+            case 2950:
+                v.data   = format(r, c, &v.length);
+                break;
+        }
+    }
+
     bool PgResult::read(ResultRow &row) {
         uint64_t len;
         unsigned char *data;
@@ -96,15 +267,10 @@ namespace dbi {
                     row[n].isnull = true;
                     row[n].value  = "";
                 }
-                else if (_rstypes[n] != DBI_TYPE_BLOB) {
-                    row[n].isnull = false;
-                    row[n].binary = false;
-                    row[n].value  = string(PQgetvalue(_result, _rowno, n), PQgetlength(_result, _rowno, n));
-                }
                 else {
-                    data = unescapeBytea(_rowno, n, &len);
+                    data = field(_rowno, n, &len);
                     row[n].isnull = false;
-                    row[n].binary = true;
+                    row[n].binary = _rstypes[n] == DBI_TYPE_BLOB;
                     row[n].value  = string((char*)data, len);
                 }
             }
@@ -125,10 +291,8 @@ namespace dbi {
             for (uint32_t i = 0; i < _cols; i++) {
                 if (PQgetisnull(_result, _rowno, i))
                     rowhash[_rsfields[i]] = PARAM(null());
-                else if (_rstypes[i] != DBI_TYPE_BLOB)
-                    rowhash[_rsfields[i]] = PG2PARAM(_result, _rowno, i);
                 else {
-                    data = unescapeBytea(_rowno, i, &len);
+                    data = field(_rowno, i, &len);
                     rowhash[_rsfields[i]] = PARAM(data, len);
                 }
             }
@@ -148,7 +312,7 @@ namespace dbi {
     }
 
     void PgResult::cleanup() {
-        if (_bytea)  PQfreemem(_bytea);
+        if (_bytea)  delete [] _bytea;
         if (_result) PQclear(_result);
 
         _rsfields.clear();
@@ -156,8 +320,9 @@ namespace dbi {
 
         _rowno  = 0;
         _rows   = 0;
-        _result = 0;
-        _bytea  = 0;
+        _result     = 0;
+        _bytea      = 0;
+        _bytea_size = 0;
     }
 
     unsigned char* PgResult::read(uint32_t r, uint32_t c, uint64_t *l) {
@@ -166,11 +331,25 @@ namespace dbi {
         _rowno = r;
         if (PQgetisnull(_result, r, c)) return 0;
 
-        if (_rstypes[c] != DBI_TYPE_BLOB) {
-            if (l) *l = PQgetlength(_result, r, c);
-            return (unsigned char*)PQgetvalue(_result, r, c);
+        return field(r, c, l);
+    }
+
+    bool PgResult::read(uint32_t r, uint32_t c, Value &v) {
+        if (r >= _rows || c >= _cols) return false;
+
+        if (PQfformat(_result, c) == 1) {
+            _rowno = r;
+            if (PQgetisnull(_result, r, c))
+                parseValue(_rstypes[c], 0, 0, v);
+            else
+                decode(r, c, v);
+            return true;
         }
-        else return unescapeBytea(r, c, l);
+
+        uint64_t length = 0;
+        unsigned char *data = read(r, c, &length);
+        parseValue(_rstypes[c], data, length, v);
+        return true;
     }
 
     uint32_t PgResult::tell() {
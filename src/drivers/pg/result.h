@@ -13,11 +13,16 @@ namespace dbi {
         int_list_t     _rstypes;
         uint32_t       _rowno, _rows, _cols, _affected_rows;
         unsigned char  *_bytea;
+        uint64_t       _bytea_size;
         string         _sql;
+        char           _text[128];
 
         void init();
         void fetchMeta();
         unsigned char* unescapeBytea(int, int, uint64_t*);
+        unsigned char* field(int, int, uint64_t*);
+        unsigned char* format(int, int, uint64_t*);
+        void decode(int, int, Value&);
 
         public:
         PgResult(PGresult*, string sql, PGconn*);
@@ -37,6 +42,7 @@ namespace dbi {
         bool           read(ResultRow &r);
         bool           read(ResultRowHash &r);
         unsigned char* read(uint32_t r, uint32_t c, uint64_t *l = 0);
+        bool           read(uint32_t r, uint32_t c, Value &v);
 
         bool     finish();
         uint32_t tell();
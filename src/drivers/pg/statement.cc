@@ -4,6 +4,8 @@ namespace dbi {
     void PgStatement::init() {
         _uuid           = generateCompactUUID();
         _result         = 0;
+        _result_format  = 0;
+        _binary_params  = false;
         _last_insert_id = 0;
     }
 
@@ -23,12 +25,43 @@ namespace dbi {
         cleanup();
     }
 
-    PgStatement::PgStatement(string normalized_sql,  PGconn **conn) {
+    PgStatement::PgStatement(string normalized_sql,  PGconn **conn, bool binary_results, bool binary_params) {
         _sql  = normalized_sql;
         _conn = conn;
 
         init();
         prepare();
+
+        // the statement is already prepared on the server, it is deallocated if describing it fails.
+        try {
+            if (binary_results || binary_params) {
+                PGresult *description = PQdescribePrepared(*_conn, _uuid.c_str());
+                if (!description) boom("Unable to allocate statement description");
+                PQ_CHECK_RESULT(&description, *_conn, _sql);
+
+                // results come back in binary format only when every column can be decoded.
+                if (binary_results)
+                    _result_format = PQ_BINARY_RESULTS(description, *_conn) ? 1 : 0;
+
+                // parameters are encoded for the types the server picked when preparing.
+                if (binary_params) {
+                    const char *integer_datetimes = PQparameterStatus(*_conn, "integer_datetimes");
+                    bool datetimes = integer_datetimes && strcmp(integer_datetimes, "on") == 0;
+
+                    _binary_params = true;
+                    for (int i = 0; i < PQnparams(description); i++) {
+                        Oid type = PQparamtype(description, i);
+                        _param_types.push_back(!datetimes && (type == 1114 || type == 1184) ? 0 : type);
+                    }
+                }
+
+                PQclear(description);
+            }
+        }
+        catch (...) {
+            cleanup();
+            throw;
+        }
     }
 
     void PgStatement::cleanup() {
@@ -53,42 +86,25 @@ namespace dbi {
         PGresult *result;
 
         finish();
-        result = PQexecPrepared(*_conn, _uuid.c_str(), 0, 0, 0, 0, 0);
+        result = PQ_EXEC_PREPARED(*_conn, _uuid.c_str(), _params, 0, _result_format);
         PQ_CHECK_RESULT(&result, *_conn, _sql);
         return _result = result;
     }
 
     PGresult* PgStatement::_pgexec(param_list_t &bind) {
-        int *param_l, *param_f;
-        const char **param_v;
         PGresult *result;
 
         if (bind.size() == 0) return _pgexec();
 
         finish();
-        PQ_PROCESS_BIND(&param_v, &param_l, &param_f, bind);
 
-        try {
-            result = PQexecPrepared(*_conn, _uuid.c_str(), bind.size(),
-                                   (const char* const *)param_v, (const int*)param_l, (const int*)param_f, 0);
-            PQ_CHECK_RESULT(&result, *_conn, _sql);
-        }
-        catch (ConnectionError &e) {
-            delete []param_v;
-            delete []param_l;
-            delete []param_f;
-            throw e;
-        }
-        catch (Error &e) {
-            delete []param_v;
-            delete []param_l;
-            delete []param_f;
-            throw e;
-        }
+        // server checks the parameter count, the types are only used if they line up.
+        bool typed = _binary_params && _param_types.size() == bind.size();
+        PQ_PROCESS_BIND(_params, bind, typed ? &_param_types[0] : 0);
+        phaseLap(DBI_PHASE_BIND);
 
-        delete []param_v;
-        delete []param_l;
-        delete []param_f;
+        result = PQ_EXEC_PREPARED(*_conn, _uuid.c_str(), _params, bind.size(), _result_format);
+        PQ_CHECK_RESULT(&result, *_conn, _sql);
 
         return _result = result;
     }
@@ -98,7 +114,7 @@ namespace dbi {
 
         PGresult *result = _pgexec();
         rows             = (uint32_t)PQntuples(result);
-        _last_insert_id  = rows > 0 ? PQgetisnull(result, 0, 0) ? 0 : atol(PQgetvalue(result, 0, 0)) : 0;
+        _last_insert_id  = PQ_LAST_INSERT_ID(result);
 
         return rows > 0 ? rows : (uint32_t)atoi(PQcmdTuples(result));
     }
@@ -108,7 +124,7 @@ namespace dbi {
 
         PGresult *result = _pgexec(bind);
         rows             = (uint32_t)PQntuples(result);
-        _last_insert_id  = rows > 0 ? PQgetisnull(result, 0, 0) ? 0 : atol(PQgetvalue(result, 0, 0)) : 0;
+        _last_insert_id  = PQ_LAST_INSERT_ID(result);
 
         return rows > 0 ? rows : (uint32_t)atoi(PQcmdTuples(result));
     }
@@ -9,6 +9,10 @@ namespace dbi {
         PGconn **_conn;
 
         PGresult *_result;
+        int _result_format;
+        bool _binary_params;
+        vector<Oid> _param_types;
+        PgParams _params;
 
         PGresult* _pgexec();
         PGresult* _pgexec(param_list_t&);
@@ -22,7 +26,7 @@ namespace dbi {
         public:
         PgStatement();
         ~PgStatement();
-        PgStatement(string query, PGconn **conn);
+        PgStatement(string query, PGconn **conn, bool binary_results = false, bool binary_params = false);
         void cleanup();
         void finish();
         string command();
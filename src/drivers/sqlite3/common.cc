@@ -33,7 +33,7 @@ using namespace dbi;
 
 extern "C" {
     Sqlite3Handle* dbdConnect(string user, string pass, string dbname, string host, string port, char *options) {
-        return new Sqlite3Handle(dbname);
+        return new Sqlite3Handle(dbname, options);
     }
 
     Driver* dbdInfo(void) {
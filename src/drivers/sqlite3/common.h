@@ -20,6 +20,7 @@ namespace dbi {
 
 #include "result.h"
 #include "statement.h"
+#include "loader.h"
 #include "handle.h"
 
 #endif
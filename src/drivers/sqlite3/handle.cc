@@ -3,20 +3,48 @@
 namespace dbi {
 
     Sqlite3Handle::Sqlite3Handle() {
-        conn       = 0;
-        _result    = 0;
-        tr_nesting = 0;
+        conn         = 0;
+        _result      = 0;
+        _cursor      = false;
+        tr_nesting   = 0;
+        _write_batch = 0;
     }
 
-    Sqlite3Handle::Sqlite3Handle(string dbname) {
-        conn       = 0;
-        _result    = 0;
-        tr_nesting = 0;
-        _dbname    = dbname;
+    Sqlite3Handle::Sqlite3Handle(string dbname, char *options) {
+        conn         = 0;
+        _result      = 0;
+        _cursor      = false;
+        tr_nesting   = 0;
+        _write_batch = 0;
+        _dbname      = dbname;
+
+        if (options)
+            parseOptions(options);
 
         reconnect();
     }
 
+    void Sqlite3Handle::parseOptions(char *options) {
+        pcrecpp::RE re("([^ =;]+) *= *([^ =;]+)");
+        pcrecpp::StringPiece input(options);
+
+        string option;
+        string value;
+
+        while (re.FindAndConsume(&input, &option, &value)) {
+            if (option == "cursor") cursor(value == "1" || value == "true");
+            if (option == "write_batch") writeBatch(strtoull(value.c_str(), 0, 10));
+        }
+    }
+
+    void Sqlite3Handle::cursor(bool flag) {
+        _cursor = flag;
+    }
+
+    void Sqlite3Handle::writeBatch(uint64_t rows) {
+        _write_batch = rows;
+    }
+
     void Sqlite3Handle::setTimeZoneOffset(int tzhour, int tzmin) {
         throw RuntimeError("Sqlite3Handle::setTimeZoneOffset is not implemented");
     }
@@ -31,6 +59,7 @@ namespace dbi {
 
     void Sqlite3Handle::cleanup() {
         if (_result) delete _result;
+        _releaseLoaders();
         if (conn)    sqlite3_close(conn);
 
         _result = 0;
@@ -46,11 +75,12 @@ namespace dbi {
     uint32_t Sqlite3Handle::execute(string sql) {
         _sql = sql;
 
-        Sqlite3Statement st(sql, conn);
+        Sqlite3Statement st(sql, conn, _cursor);
+        phaseLap(DBI_PHASE_PREPROCESS);
         st.execute();
 
         if (_result) delete _result;
-        _result = st.result();
+        _result = st.detach();
 
         return _result->rows();
     }
@@ -58,11 +88,12 @@ namespace dbi {
     uint32_t Sqlite3Handle::execute(string sql, param_list_t &bind) {
         _sql = sql;
 
-        Sqlite3Statement st(sql, conn);
+        Sqlite3Statement st(sql, conn, _cursor);
+        phaseLap(DBI_PHASE_PREPROCESS);
         st.execute(bind);
 
         if (_result) delete _result;
-        _result = st.result();
+        _result = st.detach();
 
         return _result->rows();
     }
@@ -101,7 +132,7 @@ namespace dbi {
     }
 
     Sqlite3Statement* Sqlite3Handle::prepare(string sql) {
-        return new Sqlite3Statement(sql, conn);
+        return new Sqlite3Statement(sql, conn, _cursor);
     }
 
     void Sqlite3Handle::_execute(string sql) {
@@ -160,12 +191,16 @@ namespace dbi {
     };
 
     bool Sqlite3Handle::close() {
+        _releaseLoaders();
         if (conn) sqlite3_close(conn);
         conn = 0;
         return true;
     }
 
     void Sqlite3Handle::reconnect() {
+        // the constructor opens the database through here too.
+        bool reopen = conn != 0;
+
         close();
         int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
         if (sqlite3_open_v2(_dbname.c_str(), &conn, flags, 0) != SQLITE_OK) {
@@ -173,74 +208,104 @@ namespace dbi {
             throw ConnectionError(errormsg);
         }
         else {
+            if (reopen) metrics::add(DBI_METRIC_RECONNECTS);
             snprintf(errormsg, 8192, "NOTICE: sqlite3 reopened %s", _dbname.c_str());
             if (_trace)
                 logMessage(_trace_fd, errormsg);
         }
     }
 
-    uint64_t Sqlite3Handle::write(string table, field_list_t &fields, IO* io) {
-        string sql  = "insert into " + table;
-        int columns = fields.size();
-
-        if (columns < 1) {
-            sqlite3_stmt *tmp = 0;
-            string sel = "select * from " + table + " limit 0";
-            if (sqlite3_prepare_v2(conn, sel.c_str(), sel.length(), &tmp, 0) != SQLITE_OK) {
-                if (tmp) sqlite3_finalize(tmp);
-                snprintf(errormsg, 8192, "Error in SQL: %s %s", sql.c_str(), sqlite3_errmsg(conn));
-                throw RuntimeError(errormsg);
-            }
-            columns = sqlite3_column_count(tmp);
-            sqlite3_finalize(tmp);
+    void Sqlite3Handle::_releaseLoaders() {
+        for (map<string, Sqlite3Loader*>::iterator it = _loaders.begin(); it != _loaders.end(); it++)
+            delete it->second;
+        _loaders.clear();
+    }
+
+    // loaders are cached per table and field list, a schema change discards the cached statement.
+    Sqlite3Loader* Sqlite3Handle::_loader(string table, field_list_t &fields) {
+        string key = table + "(" + fields.join(",") + ")";
+        map<string, Sqlite3Loader*>::iterator it = _loaders.find(key);
+
+        if (it != _loaders.end()) {
+            if (!it->second->stale())
+                return it->second;
+            delete it->second;
+            _loaders.erase(it);
         }
 
-        if (fields.size() > 0) sql +=  "(" + fields.join(", ") + ") ";
+        Sqlite3Loader *loader = new Sqlite3Loader(conn, table, fields);
+        _loaders[key] = loader;
+        return loader;
+    }
 
-        sql += " values(?";
-        for (int n = 1; n < columns; n++) sql += ", ?";
-        sql += ")";
+    uint64_t Sqlite3Handle::write(string table, field_list_t &fields, IO* io) {
+        return _loader(table, fields)->write(io, _write_batch);
+    }
 
-        string line;
-        uint32_t col  = 0;
-        uint64_t rows = 0;
+    uint64_t Sqlite3Handle::write(string table, field_list_t &fields, row_list_t &rows) {
+        RowList source(rows);
+        return writeRows(table, fields, source);
+    }
+
+    uint64_t Sqlite3Handle::writeRows(string table, field_list_t &fields, RowSource &source) {
+        return _loader(table, fields)->write(source, _write_batch);
+    }
+
+    uint64_t Sqlite3Handle::read(string source, field_list_t &fields, IO* io) {
+        int rc;
+        string sql;
+        const char *data;
         sqlite3_stmt *stmt = 0;
+        TsvWriter tsv(io);
+
+        if (isQuery(source))
+            sql = source;
+        else
+            sql = "select " + (fields.size() > 0 ? fields.join(", ") : string("*")) + " from " + source;
+
+        if (_trace)
+            logMessage(_trace_fd, sql);
+
         if (sqlite3_prepare_v2(conn, sql.c_str(), sql.length(), &stmt, 0) != SQLITE_OK) {
             if (stmt) sqlite3_finalize(stmt);
             snprintf(errormsg, 8192, "Error in SQL: %s %s", sql.c_str(), sqlite3_errmsg(conn));
             throw RuntimeError(errormsg);
         }
 
-        while (io->readline(line)) {
-            col = 0;
-            char *end, *start = (char*)line.c_str();
-            while (*start) {
-                end = start;
-                while (*end && *end != '\t') end++;
-
-                if (end-start == 1)
-                    sqlite3_bind_null(stmt, ++col);
-                else
-                    sqlite3_bind_text(stmt, ++col, start, end-start, 0);
-
-                start = *end ? end + 1 : end;
-            }
-
-            while (col < columns) sqlite3_bind_null(stmt, ++col);
-
-            if (sqlite3_step(stmt) != SQLITE_DONE) {
-                sqlite3_finalize(stmt);
-                snprintf(errormsg, 8192, "%s", sqlite3_errmsg(conn));
-                throw RuntimeError(errormsg);
+        int columns = sqlite3_column_count(stmt);
+        try {
+            while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+                for (int col = 0; col < columns; col++) {
+                    switch (sqlite3_column_type(stmt, col)) {
+                        case SQLITE_NULL:
+                            tsv.write(0, 0);
+                            break;
+                        case SQLITE_BLOB:
+                            // zero length blobs come back as a null pointer.
+                            data = (const char*)sqlite3_column_blob(stmt, col);
+                            tsv.write(data ? data : "", sqlite3_column_bytes(stmt, col));
+                            break;
+                        default:
+                            tsv.write((const char*)sqlite3_column_text(stmt, col), sqlite3_column_bytes(stmt, col));
+                    }
+                }
+                tsv.end();
             }
+            tsv.flush();
+        }
+        catch (...) {
+            sqlite3_finalize(stmt);
+            throw;
+        }
 
-            sqlite3_clear_bindings(stmt);
-            sqlite3_reset(stmt);
-            rows++;
+        if (rc != SQLITE_DONE) {
+            snprintf(errormsg, 8192, "Error in SQL: %s %s", sql.c_str(), sqlite3_errmsg(conn));
+            sqlite3_finalize(stmt);
+            throw RuntimeError(errormsg);
         }
 
         sqlite3_finalize(stmt);
-        return rows;
+        return tsv.rows();
     }
 
     string Sqlite3Handle::escape(string value) {
@@ -9,8 +9,14 @@ namespace dbi {
         string _sql;
         Sqlite3Result *_result;
         string _dbname;
+        bool _cursor;
+        uint64_t _write_batch;
+        map<string, Sqlite3Loader*> _loaders;
 
         void _execute(string);
+        Sqlite3Loader* _loader(string table, field_list_t &fields);
+        void _releaseLoaders();
+        void parseOptions(char*);
 
         protected:
         int tr_nesting;
@@ -19,7 +25,7 @@ namespace dbi {
         sqlite3 *conn;
 
         Sqlite3Handle();
-        Sqlite3Handle(string dbname);
+        Sqlite3Handle(string dbname, char *options = 0);
         ~Sqlite3Handle();
         void cleanup();
 
@@ -49,10 +55,16 @@ namespace dbi {
         void reconnect();
 
         uint64_t write(string table, field_list_t &fields, IO*);
+        uint64_t write(string table, field_list_t &fields, row_list_t &rows);
+        uint64_t writeRows(string table, field_list_t &fields, RowSource &source);
+        uint64_t read(string table_or_query, field_list_t &fields, IO*);
         void setTimeZoneOffset(int, int);
         void setTimeZone(char *);
         string escape(string);
         string driver();
+
+        void cursor(bool);
+        void writeBatch(uint64_t);
     };
 }
 
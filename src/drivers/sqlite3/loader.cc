@@ -0,0 +1,331 @@
+#include "common.h"
+
+#define SQLITE3_LOADER_CHUNK 1048576
+
+namespace dbi {
+
+    int SQLITE3_AFFINITY(const char *type) {
+        if (!type || !*type) return SQLITE3_AFFINITY_NONE;
+
+        string name(type);
+        for (uint32_t n = 0; n < name.length(); n++) name[n] = toupper(name[n]);
+
+        if (name.find("INT")  != string::npos) return SQLITE3_AFFINITY_INTEGER;
+        if (name.find("CHAR") != string::npos || name.find("CLOB") != string::npos || name.find("TEXT") != string::npos)
+            return SQLITE3_AFFINITY_TEXT;
+        if (name.find("BLOB") != string::npos) return SQLITE3_AFFINITY_BLOB;
+        if (name.find("REAL") != string::npos || name.find("FLOA") != string::npos || name.find("DOUB") != string::npos)
+            return SQLITE3_AFFINITY_REAL;
+
+        return SQLITE3_AFFINITY_NUMERIC;
+    }
+
+    // strict integer parse, anything sqlite might treat differently is left to sqlite.
+    static bool SQLITE3_PARSE_INT(const char *data, uint64_t len, sqlite3_int64 *value) {
+        bool negative = false;
+        if (len > 0 && (*data == '-' || *data == '+')) {
+            negative = *data == '-';
+            data++; len--;
+        }
+
+        if (len == 0 || len > 18) return false;
+
+        sqlite3_int64 n = 0;
+        for (uint64_t i = 0; i < len; i++) {
+            if (data[i] < '0' || data[i] > '9') return false;
+            n = n * 10 + (data[i] - '0');
+        }
+
+        *value = negative ? -n : n;
+        return true;
+    }
+
+    // plain decimal or exponent notation only, no hex, inf or nan.
+    static bool SQLITE3_PARSE_REAL(const char *data, uint64_t len, double *value) {
+        char number[64], *end;
+        if (len == 0 || len >= sizeof(number)) return false;
+
+        for (uint64_t i = 0; i < len; i++) {
+            if (!strchr("0123456789+-.eE", data[i]) || !data[i]) return false;
+        }
+
+        memcpy(number, data, len);
+        number[len] = 0;
+
+        *value = strtod(number, &end);
+        return end == number + len;
+    }
+
+    static void SQLITE3_UNESCAPE(string &out, const char *data, uint64_t len) {
+        out.clear();
+        const char *end = data + len;
+        while (data < end) {
+            const char *slash = (const char*)memchr(data, '\\', end - data);
+            if (!slash) {
+                out.append(data, end - data);
+                break;
+            }
+
+            out.append(data, slash - data);
+            if (slash + 1 == end) {
+                out += '\\';
+                break;
+            }
+
+            switch (slash[1]) {
+                case 't': out += '\t'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case '0': out += '\0'; break;
+                default:  out += slash[1];
+            }
+            data = slash + 2;
+        }
+    }
+
+    Sqlite3Loader::Sqlite3Loader(sqlite3 *c, string table, field_list_t &fields) {
+        conn    = c;
+        stmt    = 0;
+        schema  = schemaVersion(conn);
+        rows    = batch = pending = 0;
+        owner   = false;
+
+        // column count and declared types, the select is only prepared, never stepped.
+        sqlite3_stmt *meta = 0;
+        string sel = "select " + (fields.size() > 0 ? fields.join(", ") : string("*")) + " from " + table;
+        if (sqlite3_prepare_v2(conn, sel.c_str(), sel.length(), &meta, 0) != SQLITE_OK) {
+            if (meta) sqlite3_finalize(meta);
+            snprintf(errormsg, 8192, "Error in SQL: %s %s", sel.c_str(), sqlite3_errmsg(conn));
+            throw RuntimeError(errormsg);
+        }
+
+        columns = sqlite3_column_count(meta);
+        for (int col = 0; col < columns; col++)
+            affinity.push_back(SQLITE3_AFFINITY(sqlite3_column_decltype(meta, col)));
+        sqlite3_finalize(meta);
+
+        scratch.resize(columns);
+
+        sql = "insert into " + table;
+        if (fields.size() > 0) sql +=  "(" + fields.join(", ") + ")";
+
+        sql += " values(?";
+        for (int n = 1; n < columns; n++) sql += ", ?";
+        sql += ")";
+
+        if (sqlite3_prepare_v2(conn, sql.c_str(), sql.length(), &stmt, 0) != SQLITE_OK) {
+            if (stmt) sqlite3_finalize(stmt);
+            snprintf(errormsg, 8192, "Error in SQL: %s %s", sql.c_str(), sqlite3_errmsg(conn));
+            throw RuntimeError(errormsg);
+        }
+    }
+
+    Sqlite3Loader::~Sqlite3Loader() {
+        if (stmt) sqlite3_finalize(stmt);
+    }
+
+    int Sqlite3Loader::schemaVersion(sqlite3 *conn) {
+        int version = -1;
+        sqlite3_stmt *pragma = 0;
+        if (sqlite3_prepare_v2(conn, "pragma schema_version", -1, &pragma, 0) == SQLITE_OK) {
+            if (sqlite3_step(pragma) == SQLITE_ROW)
+                version = sqlite3_column_int(pragma, 0);
+        }
+        if (pragma) sqlite3_finalize(pragma);
+        return version;
+    }
+
+    bool Sqlite3Loader::stale() {
+        return schemaVersion(conn) != schema;
+    }
+
+    // a load runs in its own transaction unless the caller already has one open.
+    void Sqlite3Loader::begin() {
+        rows    = pending = 0;
+        owner   = sqlite3_get_autocommit(conn) != 0;
+        if (owner && sqlite3_exec(conn, "BEGIN", 0, 0, 0) != SQLITE_OK) {
+            snprintf(errormsg, 8192, "%s", sqlite3_errmsg(conn));
+            throw RuntimeError(errormsg);
+        }
+    }
+
+    void Sqlite3Loader::finish(bool ok) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        carry.clear();
+
+        if (!owner) return;
+        owner = false;
+
+        if (!ok) {
+            sqlite3_exec(conn, "ROLLBACK", 0, 0, 0);
+        }
+        else if (sqlite3_exec(conn, "COMMIT", 0, 0, 0) != SQLITE_OK) {
+            snprintf(errormsg, 8192, "%s", sqlite3_errmsg(conn));
+            sqlite3_exec(conn, "ROLLBACK", 0, 0, 0);
+            throw RuntimeError(errormsg);
+        }
+    }
+
+    void Sqlite3Loader::insert() {
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            snprintf(errormsg, 8192, "Row %lu: %s", (unsigned long)rows + 1, sqlite3_errmsg(conn));
+            throw RuntimeError(errormsg);
+        }
+
+        sqlite3_reset(stmt);
+        rows++;
+
+        if (owner && batch > 0 && ++pending >= batch) {
+            pending = 0;
+            if (sqlite3_exec(conn, "COMMIT; BEGIN", 0, 0, 0) != SQLITE_OK) {
+                snprintf(errormsg, 8192, "%s", sqlite3_errmsg(conn));
+                throw RuntimeError(errormsg);
+            }
+        }
+    }
+
+    // binds use SQLITE_STATIC, data has to stay valid until the row is stepped.
+    void Sqlite3Loader::bind(int col, const char *data, uint64_t len, bool escaped) {
+        sqlite3_int64 i;
+        double d;
+
+        if (escaped && memchr(data, '\\', len)) {
+            if (len == 2 && data[1] == 'N') {
+                sqlite3_bind_null(stmt, col + 1);
+                return;
+            }
+            SQLITE3_UNESCAPE(scratch[col], data, len);
+            data = scratch[col].data();
+            len  = scratch[col].length();
+        }
+
+        switch (affinity[col]) {
+            case SQLITE3_AFFINITY_INTEGER:
+            case SQLITE3_AFFINITY_NUMERIC:
+                if (SQLITE3_PARSE_INT(data, len, &i)) {
+                    sqlite3_bind_int64(stmt, col + 1, i);
+                    return;
+                }
+                break;
+            case SQLITE3_AFFINITY_REAL:
+                if (SQLITE3_PARSE_REAL(data, len, &d)) {
+                    sqlite3_bind_double(stmt, col + 1, d);
+                    return;
+                }
+                break;
+            case SQLITE3_AFFINITY_BLOB:
+                sqlite3_bind_blob(stmt, col + 1, data, len, SQLITE_STATIC);
+                return;
+        }
+
+        // sqlite applies the column affinity to anything not handled above.
+        sqlite3_bind_text(stmt, col + 1, data, len, SQLITE_STATIC);
+    }
+
+    void Sqlite3Loader::line(const char *start, const char *end) {
+        int col = 0;
+        const char *tab;
+
+        while (true) {
+            if (col == columns) {
+                snprintf(errormsg, 8192, "Row %lu has more than %d fields", (unsigned long)rows + 1, columns);
+                throw RuntimeError(errormsg);
+            }
+
+            tab = (const char*)memchr(start, '\t', end - start);
+            bind(col++, start, (tab ? tab : end) - start, true);
+            if (!tab) break;
+            start = tab + 1;
+        }
+
+        while (col < columns) sqlite3_bind_null(stmt, ++col);
+        insert();
+    }
+
+    uint64_t Sqlite3Loader::write(IO *io, uint64_t size) {
+        batch = size;
+        begin();
+
+        try {
+            const char *data, *start, *end, *nl;
+            while (true) {
+                uint64_t len = io->read(&data, SQLITE3_LOADER_CHUNK);
+                if (len == 0) {
+                    buffer.resize(SQLITE3_LOADER_CHUNK);
+                    len  = io->read(&buffer[0], SQLITE3_LOADER_CHUNK);
+                    data = buffer.data();
+                }
+
+                if (len == 0) break;
+
+                start = data;
+                end   = data + len;
+
+                // finish a line that straddled the previous chunk.
+                if (!carry.empty()) {
+                    nl = (const char*)memchr(start, '\n', len);
+                    if (!nl) {
+                        carry.append(start, len);
+                        continue;
+                    }
+                    carry.append(start, nl - start);
+                    line(carry.data(), carry.data() + carry.length());
+                    carry.clear();
+                    start = nl + 1;
+                }
+
+                while (start < end && (nl = (const char*)memchr(start, '\n', end - start))) {
+                    line(start, nl);
+                    start = nl + 1;
+                }
+
+                if (start < end) carry.assign(start, end - start);
+            }
+
+            if (!carry.empty()) line(carry.data(), carry.data() + carry.length());
+        }
+        catch (...) {
+            finish(false);
+            throw;
+        }
+
+        finish(true);
+        return rows;
+    }
+
+    uint64_t Sqlite3Loader::write(RowSource &source, uint64_t size) {
+        ResultRow *row;
+
+        batch = size;
+        begin();
+
+        try {
+            while ((row = source.next())) {
+                if (row->size() != columns) {
+                    snprintf(errormsg, 8192, "Row %lu has %d values, expected %d", (unsigned long)rows, row->size(), columns);
+                    throw RuntimeError(errormsg);
+                }
+
+                for (int col = 0; col < columns; col++) {
+                    Param &p = (*row)[col];
+                    if (p.isnull)
+                        sqlite3_bind_null(stmt, col + 1);
+                    else if (p.binary)
+                        sqlite3_bind_blob(stmt, col + 1, p.value.data(), p.value.length(), SQLITE_STATIC);
+                    else
+                        bind(col, p.value.data(), p.value.length(), false);
+                }
+
+                insert();
+            }
+        }
+        catch (...) {
+            finish(false);
+            throw;
+        }
+
+        finish(true);
+        return rows;
+    }
+}
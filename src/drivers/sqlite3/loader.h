@@ -0,0 +1,48 @@
+#ifndef _DBICXX_SQLITE3_LOADER_H
+#define _DBICXX_SQLITE3_LOADER_H
+
+namespace dbi {
+
+    // column affinities, following the rules in http://www.sqlite.org/datatype3.html
+    #define SQLITE3_AFFINITY_NONE    0
+    #define SQLITE3_AFFINITY_TEXT    1
+    #define SQLITE3_AFFINITY_NUMERIC 2
+    #define SQLITE3_AFFINITY_INTEGER 3
+    #define SQLITE3_AFFINITY_REAL    4
+    #define SQLITE3_AFFINITY_BLOB    5
+
+    int SQLITE3_AFFINITY(const char *decltype_name);
+
+    // prepared insert and column affinities for one table and field list. loaders are cached on the
+    // handle and rebuilt when the schema version changes.
+    class Sqlite3Loader {
+        private:
+        sqlite3        *conn;
+        sqlite3_stmt   *stmt;
+        string          sql;
+        int             columns, schema;
+        vector<int>     affinity;
+        string_list_t   scratch;
+        string          carry, buffer;
+        uint64_t        rows, batch, pending;
+        bool            owner;
+
+        static int schemaVersion(sqlite3 *);
+
+        void begin();
+        void finish(bool ok);
+        void insert();
+        void bind(int col, const char *data, uint64_t len, bool escaped);
+        void line(const char *start, const char *end);
+
+        public:
+        Sqlite3Loader(sqlite3 *conn, string table, field_list_t &fields);
+        ~Sqlite3Loader();
+
+        bool stale();
+        uint64_t write(IO*, uint64_t batch);
+        uint64_t write(RowSource &source, uint64_t batch);
+    };
+}
+
+#endif
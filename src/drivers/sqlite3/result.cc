@@ -10,6 +10,11 @@ namespace dbi {
         _lazy_typed     = false;
         affected_rows   = 0;
         last_insert_id  = 0;
+        _stmt           = 0;
+        _cursor         = false;
+        _pending        = false;
+        _finalize       = false;
+        _owner          = 0;
     }
 
     void Sqlite3Result::clear() {
@@ -26,13 +31,105 @@ namespace dbi {
         cleanup();
     }
 
-    Sqlite3Result::Sqlite3Result(sqlite3_stmt *stmt, string sql) {
+    Sqlite3Result::Sqlite3Result(sqlite3_stmt *stmt, string sql, bool cursor) {
         init();
 
-        _sql = sql;
+        _sql    = sql;
+        _cursor = cursor;
+        _stmt   = cursor ? stmt : 0;
         fetchMeta(stmt);
     }
 
+    // called by the statement once the first sqlite3_step() is done.
+    void Sqlite3Result::ready(bool row) {
+        _pending = row;
+        if (!row) release();
+    }
+
+    void Sqlite3Result::track(Sqlite3Result **owner) {
+        _owner = owner;
+        *owner = this;
+    }
+
+    // take over the sqlite3_stmt, it gets finalized along with the result.
+    void Sqlite3Result::adopt() {
+        if (_owner && *_owner == this) *_owner = 0;
+        _owner    = 0;
+        _finalize = true;
+    }
+
+    void Sqlite3Result::release() {
+        if (_owner && *_owner == this) *_owner = 0;
+        if (_finalize && _stmt) sqlite3_finalize(_stmt);
+
+        _owner    = 0;
+        _stmt     = 0;
+        _pending  = false;
+        _finalize = false;
+    }
+
+    bool Sqlite3Result::step() {
+        if (_pending) {
+            _pending = false;
+        }
+        else {
+            if (!_stmt) return false;
+
+            int rc = sqlite3_step(_stmt);
+            if (rc == SQLITE_DONE) {
+                release();
+                return false;
+            }
+
+            if (rc != SQLITE_ROW) {
+                snprintf(errormsg, 8192, "%s", sqlite3_errmsg(sqlite3_db_handle(_stmt)));
+                release();
+                throw RuntimeError(errormsg);
+            }
+        }
+
+        if (_lazy_typed) fetchTypes(_stmt);
+
+        _rows++;
+        _rowno++;
+        return true;
+    }
+
+    // forward only, either the row we have or the one after it.
+    bool Sqlite3Result::locate(uint32_t r) {
+        if (r + 1 == _rowno) return _stmt != 0;
+        if (r != _rowno) throw RuntimeError("Cursor results can only be read sequentially");
+        return step();
+    }
+
+    // pointers returned by sqlite3_column_*() are valid until the next step.
+    unsigned char* Sqlite3Result::column(int c, uint64_t *l) {
+        unsigned char *data;
+
+        switch(sqlite3_column_type(_stmt, c)) {
+            case SQLITE_NULL:
+                return 0;
+            case SQLITE_TEXT:
+            case SQLITE_BLOB:
+                data = (unsigned char*)sqlite3_column_blob(_stmt, c);
+                if (l) *l = sqlite3_column_bytes(_stmt, c);
+                return data ? data : (unsigned char*)"";
+            default:
+                data = (unsigned char*)sqlite3_column_text(_stmt, c);
+                if (l) *l = data ? strlen((char*)data) : 0;
+                return data;
+        }
+    }
+
+    void Sqlite3Result::column(int c, Param &p) {
+        uint64_t length = 0;
+        unsigned char *data = column(c, &length);
+
+        p.isnull = data == 0;
+        p.value  = data ? string((char*)data, length) : "";
+        p.binary = _rstypes[c] == DBI_TYPE_BLOB;
+    }
+
     void Sqlite3Result::fetchMeta(sqlite3_stmt *stmt) {
         _cols = sqlite3_column_count(stmt);
         for (int n = 0; n < _cols; n++) {
@@ -88,19 +185,22 @@ namespace dbi {
         _rowno++;
         _rows++;
 
-        if (_rowno == 1 && _lazy_typed) {
-            for (int n = 0; n < _cols; n++) {
-                if (_rstypes[n] != DBI_TYPE_UNKNOWN) continue;
-                switch(sqlite3_column_type(stmt, n)) {
-                    case SQLITE_INTEGER: _rstypes[n] = DBI_TYPE_INT;   break;
-                    case SQLITE_FLOAT:   _rstypes[n] = DBI_TYPE_FLOAT; break;
-                    case SQLITE_BLOB:    _rstypes[n] = DBI_TYPE_BLOB;  break;
-                    default:             _rstypes[n] = DBI_TYPE_TEXT;
-                }
-            }
+        if (_rowno == 1 && _lazy_typed) fetchTypes(stmt);
+    }
 
-            _lazy_typed = false;
+    // columns without a declared type are typed by the values in the first row.
+    void Sqlite3Result::fetchTypes(sqlite3_stmt *stmt) {
+        for (int n = 0; n < _cols; n++) {
+            if (_rstypes[n] != DBI_TYPE_UNKNOWN) continue;
+            switch(sqlite3_column_type(stmt, n)) {
+                case SQLITE_INTEGER: _rstypes[n] = DBI_TYPE_INT;   break;
+                case SQLITE_FLOAT:   _rstypes[n] = DBI_TYPE_FLOAT; break;
+                case SQLITE_BLOB:    _rstypes[n] = DBI_TYPE_BLOB;  break;
+                default:             _rstypes[n] = DBI_TYPE_TEXT;
+            }
         }
+
+        _lazy_typed = false;
     }
 
     uint32_t Sqlite3Result::rows() {
@@ -120,6 +220,13 @@ namespace dbi {
     }
 
     bool Sqlite3Result::read(ResultRow &row) {
+        if (_cursor) {
+            if (!step()) return false;
+            row.resize(_cols);
+            for (int n = 0; n < _cols; n++) column(n, row[n]);
+            return true;
+        }
+
         if (_rowno < _rows) {
             row = _rowdata[_rowno++];
             return true;
@@ -128,6 +235,13 @@ namespace dbi {
     }
 
     bool Sqlite3Result::read(ResultRowHash &rowhash) {
+        if (_cursor) {
+            if (!step()) return false;
+            rowhash.clear();
+            for (int n = 0; n < _cols; n++) column(n, rowhash[_rsfields[n]]);
+            return true;
+        }
+
         if (_rowno < _rows) {
             rowhash.clear();
             for (int n = 0; n < _cols; n++) rowhash[_rsfields[n]] = _rowdata[_rowno][n];
@@ -138,6 +252,11 @@ namespace dbi {
     }
 
     unsigned char* Sqlite3Result::read(uint32_t r, uint32_t c, uint64_t *l) {
+        if (_cursor) {
+            if (c >= _cols || !locate(r)) return 0;
+            return column(c, l);
+        }
+
         if (r >= _rows || c >= _cols || r < 0 || c < 0) return 0;
 
         if (_rowdata[r][c].isnull) {
@@ -149,6 +268,42 @@ namespace dbi {
         }
     }
 
+    bool Sqlite3Result::read(uint32_t r, uint32_t c, Value &v) {
+        if (_cursor) {
+            if (c >= _cols || !locate(r)) return false;
+
+            // numeric values are handed out as stored, without a round trip through text.
+            int type = sqlite3_column_type(_stmt, c);
+            if (type == SQLITE_INTEGER && (_rstypes[c] == DBI_TYPE_INT || _rstypes[c] == DBI_TYPE_BOOLEAN)) {
+                v.type   = _rstypes[c];
+                v.isnull = false;
+                v.data   = 0;
+                v.length = 0;
+                v.i      = sqlite3_column_int64(_stmt, c);
+            }
+            else if (type == SQLITE_FLOAT && _rstypes[c] == DBI_TYPE_FLOAT) {
+                v.type   = _rstypes[c];
+                v.isnull = false;
+                v.data   = 0;
+                v.length = 0;
+                v.f      = sqlite3_column_double(_stmt, c);
+            }
+            else {
+                uint64_t length = 0;
+                unsigned char *data = column(c, &length);
+                parseValue(_rstypes[c], data, length, v);
+            }
+            return true;
+        }
+
+        if (r >= _rows || c >= _cols) return false;
+
+        uint64_t length = 0;
+        unsigned char *data = read(r, c, &length);
+        parseValue(_rstypes[c], data, length, v);
+        return true;
+    }
+
     string_list_t& Sqlite3Result::fields() {
         return _rsfields;
     }
@@ -158,6 +313,7 @@ namespace dbi {
     }
 
     void Sqlite3Result::cleanup() {
+        release();
         _rsfields.clear();
         _rstypes.clear();
         _rowdata.clear();
@@ -172,10 +328,11 @@ namespace dbi {
     }
 
     void Sqlite3Result::rewind() {
-        _rowno = 0;
+        seek(0);
     }
 
     void Sqlite3Result::seek(uint32_t r) {
+        if (_cursor && r != _rowno) throw RuntimeError("Cursor results cannot seek");
         _rowno = r;
     }
 
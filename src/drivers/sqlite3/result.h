@@ -12,14 +12,26 @@ namespace dbi {
         string_list_t     _rsfields;
         vector<ResultRow> _rowdata;
 
+        // cursor mode, rows are stepped on demand.
+        sqlite3_stmt      *_stmt;
+        bool              _cursor, _pending, _finalize;
+        Sqlite3Result     **_owner;
+
         void init();
         void fetchMeta(sqlite3_stmt*);
+        void fetchTypes(sqlite3_stmt*);
+
+        protected:
+        bool step();
+        bool locate(uint32_t r);
+        unsigned char* column(int c, uint64_t *l);
+        void column(int c, Param &p);
 
         public:
         uint32_t affected_rows;
         uint64_t last_insert_id;
 
-        Sqlite3Result(sqlite3_stmt *stmt, string sql);
+        Sqlite3Result(sqlite3_stmt *stmt, string sql, bool cursor = false);
         ~Sqlite3Result();
 
         void cleanup();
@@ -35,6 +47,7 @@ namespace dbi {
         bool           read(ResultRow &r);
         bool           read(ResultRowHash &r);
         unsigned char* read(uint32_t r, uint32_t c, uint64_t *l = 0);
+        bool           read(uint32_t r, uint32_t c, Value &v);
 
         bool     finish();
         uint32_t tell();
@@ -44,6 +57,11 @@ namespace dbi {
         void write(int c, unsigned char *data, uint64_t length);
         void flush(sqlite3_stmt*);
         void clear();
+
+        void ready(bool row);
+        void track(Sqlite3Result **owner);
+        void adopt();
+        void release();
     };
 }
 
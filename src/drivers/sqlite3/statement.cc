@@ -1,11 +1,13 @@
 #include "common.h"
 
 namespace dbi {
-    Sqlite3Statement::Sqlite3Statement(string sql,  sqlite3 *conn) {
-        _sql    = sql;
-        _conn   = conn;
-        _stmt   = 0;
-        _result = 0;
+    Sqlite3Statement::Sqlite3Statement(string sql,  sqlite3 *conn, bool cursor) {
+        _sql       = sql;
+        _conn      = conn;
+        _stmt      = 0;
+        _result    = 0;
+        _streaming = 0;
+        _cursor    = cursor;
 
         SQLITE3_PREPROCESS_QUERY(sql);
         if (sqlite3_prepare_v2(conn, sql.c_str(), sql.length(), &_stmt, 0) != SQLITE_OK) {
@@ -29,6 +31,9 @@ namespace dbi {
     }
 
     void Sqlite3Statement::finish() {
+        // a cursor result still stepping through _stmt is done once the statement is reset.
+        if (_streaming) _streaming->release();
+
         if (_stmt) {
             sqlite3_reset(_stmt);
             sqlite3_clear_bindings(_stmt);
@@ -61,11 +66,36 @@ namespace dbi {
             throw RuntimeError(errormsg);
         }
 
+        if (_cursor && sqlite3_column_count(_stmt) > 0) {
+            if (_result) delete _result;
+            _result = new Sqlite3Result(_stmt, _sql, true);
+
+            if (bind.size() > 0) SQLITE3_PROCESS_BIND(_stmt, bind);
+            phaseLap(DBI_PHASE_BIND);
+
+            // step once so errors surface here, rest of the rows are stepped as they are read.
+            rc = sqlite3_step(_stmt);
+            phaseLap(DBI_PHASE_WAIT);
+            if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+                snprintf(errormsg, 8192, "%s", sqlite3_errmsg(_conn));
+                throw RuntimeError(errormsg);
+            }
+
+            _result->track(&_streaming);
+            _result->ready(rc == SQLITE_ROW);
+            _result->last_insert_id = last_insert_id = sqlite3_last_insert_rowid(_conn);
+            return _result->rows();
+        }
+
         if (_result) _result->clear();
         else _result = new Sqlite3Result(_stmt, _sql);
 
         if (bind.size() > 0) SQLITE3_PROCESS_BIND(_stmt, bind);
+        phaseLap(DBI_PHASE_BIND);
+
+        // stepping is the server wait, copying rows into the result the fetch.
         while ((rc = sqlite3_step(_stmt)) == SQLITE_ROW) {
+            phaseLap(DBI_PHASE_WAIT);
             for (n = 0; n < _result->columns(); n++) {
                 switch(sqlite3_column_type(_stmt, n)) {
                     case SQLITE_NULL:
@@ -83,7 +113,9 @@ namespace dbi {
                 }
             }
             _result->flush(_stmt);
+            phaseLap(DBI_PHASE_FETCH);
         }
+        phaseLap(DBI_PHASE_WAIT);
 
         if (rc != SQLITE_DONE) {
             snprintf(errormsg, 8192, "%s", sqlite3_errmsg(_conn));
@@ -102,6 +134,17 @@ namespace dbi {
         return instance;
     }
 
+    // hands the result out along with the sqlite3_stmt a cursor result still needs,
+    // used when the statement goes away before the result does.
+    Sqlite3Result* Sqlite3Statement::detach() {
+        Sqlite3Result *instance = result();
+        if (instance && instance == _streaming) {
+            instance->adopt();
+            _stmt = 0;
+        }
+        return instance;
+    }
+
     uint64_t Sqlite3Statement::lastInsertID() {
         return last_insert_id;
     }
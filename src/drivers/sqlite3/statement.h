@@ -10,6 +10,8 @@ namespace dbi {
         sqlite3 *_conn;
         sqlite3_stmt *_stmt;
         Sqlite3Result *_result;
+        Sqlite3Result *_streaming;
+        bool _cursor;
 
         protected:
         uint64_t last_insert_id;
@@ -17,7 +19,7 @@ namespace dbi {
         public:
         Sqlite3Statement();
         ~Sqlite3Statement();
-        Sqlite3Statement(string query, sqlite3 *conn);
+        Sqlite3Statement(string query, sqlite3 *conn, bool cursor = false);
         void cleanup();
         void finish();
         string command();
@@ -27,6 +29,7 @@ namespace dbi {
         uint64_t lastInsertID();
 
         Sqlite3Result* result();
+        Sqlite3Result* detach();
     };
 }
 
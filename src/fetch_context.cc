@@ -0,0 +1,70 @@
+#include "dbic++.h"
+
+namespace dbi {
+
+    FetchContext::FetchContext(FetchContext *p) {
+        refs    = 1;
+        latency = 0;
+        handle  = 0;
+        parent  = p ? p->retain() : 0;
+    }
+
+    FetchContext::~FetchContext() {
+        delete __atomic_load_n(&latency, __ATOMIC_ACQUIRE);
+        if (parent) parent->release();
+    }
+
+    FetchContext* FetchContext::retain() {
+        __atomic_add_fetch(&refs, 1, __ATOMIC_RELAXED);
+        return this;
+    }
+
+    void FetchContext::release() {
+        if (__atomic_sub_fetch(&refs, 1, __ATOMIC_ACQ_REL) == 0) delete this;
+    }
+
+    Histogram& FetchContext::fetchLatency() {
+        Histogram *current = __atomic_load_n(&latency, __ATOMIC_ACQUIRE), *fresh;
+        if (current) return *current;
+
+        // a result on another thread may be asking at the same time.
+        fresh = new Histogram();
+        if (!__atomic_compare_exchange_n(&latency, &current, fresh, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            delete fresh;
+            return *current;
+        }
+        return *fresh;
+    }
+
+    bool FetchContext::timed() {
+        return __atomic_load_n(&latency, __ATOMIC_ACQUIRE) || (parent && parent->timed());
+    }
+
+    Handle* FetchContext::source() {
+        return parent ? parent->source() : handle;
+    }
+
+    bool FetchContext::observed() {
+        return parent ? parent->observed() : handle && observers.size() > 0;
+    }
+
+    // decode time goes to the last execution and the totals of this context and its parent.
+    void FetchContext::recordFetch(uint64_t elapsed) {
+        for (FetchContext *context = this; context; context = context->parent) {
+            Histogram *histogram = __atomic_load_n(&context->latency, __ATOMIC_ACQUIRE);
+            if (histogram) histogram->record(elapsed);
+        }
+
+        if (_phase_timing) {
+            PhaseTimes *decode[3] = {&phases, &totals, parent ? &parent->totals : 0};
+            phaseAdd(decode, DBI_PHASE_DECODE, elapsed);
+        }
+    }
+
+    void FetchContext::reset() {
+        Histogram *histogram = __atomic_load_n(&latency, __ATOMIC_ACQUIRE);
+        if (histogram) histogram->reset();
+        phases.reset();
+        totals.reset();
+    }
+}
@@ -2,7 +2,10 @@
 
 #ifndef HAS_GETLINE
 size_t getline(char **lineptr, size_t *size, FILE *fp) {
-    if (!*lineptr) *lineptr = (char*)malloc(*size + 1);
+    if (!*lineptr) {
+        if (*size == 0) *size = 65536;
+        *lineptr = (char*)malloc(*size + 1);
+    }
     if (!*lineptr) return -1;
 
     if (fgets(*lineptr, *size, fp) != NULL)
@@ -13,7 +16,7 @@ size_t getline(char **lineptr, size_t *size, FILE *fp) {
 #endif
 
 namespace dbi {
-    FileIO::FileIO(const char *path, char* mode) {
+    FileIO::FileIO(const char *path, const char* mode) {
         if (!(fp = fopen(path, mode)))
             throw RuntimeError(strerror(errno));
     }
@@ -47,23 +50,32 @@ namespace dbi {
         write(data, strlen(data));
     }
 
-    void FileIO::write(const char *data, uint32_t size) {
-        if (fp)
-            size = ::write(fileno(fp), data, size);
+    void FileIO::write(const char *data, uint64_t size) {
+        ssize_t n;
+        while (fp && size > 0) {
+            if ((n = ::write(fileno(fp), data, size)) < 0) {
+                if (errno == EINTR) continue;
+                throw RuntimeError(strerror(errno));
+            }
+            data += n;
+            size -= n;
+        }
     }
 
     bool FileIO::readline(string &line) {
-        size_t size;
+        ssize_t len;
+        size_t size  = 0;
         char *buffer = 0;
 
-        size = getline(&buffer, &size, fp);
-        if (size >= 0) {
-            line = string(buffer, size);
-            free(buffer);
-            return true;
+        len = getline(&buffer, &size, fp);
+        if (len >= 0) {
+            // strip the terminator, same as StringIO::readline
+            if (len > 0 && buffer[len - 1] == '\n') len--;
+            line = string(buffer, len);
         }
 
-        return false;
+        free(buffer);
+        return len >= 0;
     }
 
     char* FileIO::readline() {
@@ -1,4 +1,5 @@
 #include "dbic++.h"
+#include <algorithm>
 
 namespace dbi {
     extern map<string, Driver *> drivers;
@@ -6,12 +7,41 @@ namespace dbi {
 
     Handle::Handle(string driver_name, string user, string pass, string dbname, string host, string port, char *options) {
         initCheck(driver_name);
-        h = drivers[driver_name]->connect(user, pass, dbname, host, port, options);
+        try {
+            h = drivers[driver_name]->connect(user, pass, dbname, host, port, options);
+        }
+        catch (...) {
+            metrics::error();
+            throw;
+        }
+        metrics::add(DBI_METRIC_CONNECTIONS_OPENED);
+        _context     = new FetchContext();
+        _context->handle = this;
+        _open        = true;
+        _fingerprint = _rows = 0;
+        _dbname         = dbname;
+        _host           = host;
+        _slow_threshold = 0;
+        if (observed()) notifyConnect(this);
     }
 
     Handle::Handle(string driver_name, string user, string pass, string dbname) {
         initCheck(driver_name);
-        h = drivers[driver_name]->connect(user, pass, dbname, "", "", 0);
+        try {
+            h = drivers[driver_name]->connect(user, pass, dbname, "", "", 0);
+        }
+        catch (...) {
+            metrics::error();
+            throw;
+        }
+        metrics::add(DBI_METRIC_CONNECTIONS_OPENED);
+        _context     = new FetchContext();
+        _context->handle = this;
+        _open        = true;
+        _fingerprint = _rows = 0;
+        _dbname         = dbname;
+        _slow_threshold = 0;
+        if (observed()) notifyConnect(this);
     }
 
     AbstractHandle* Handle::conn() {
@@ -20,31 +50,129 @@ namespace dbi {
 
     Handle::Handle(AbstractHandle *ah) {
         h = ah;
+        _context     = new FetchContext();
+        _context->handle = this;
+        _open        = false;
+        _fingerprint = _rows = 0;
+        _slow_threshold = 0;
     }
 
     Handle::~Handle() {
+        if (_open) metrics::add(DBI_METRIC_CONNECTIONS_CLOSED);
         if (h) delete h;
         h = 0;
+        _context->handle = 0;
+        _context->release();
+    }
+
+    // called from the catch block on errors.
+    void Handle::record(string &sql, param_list_t *bind, uint64_t elapsed, uint32_t rows, bool error) {
+        phaseEnd();
+        metrics::add(DBI_METRIC_QUERIES);
+        if (error) metrics::error();
+        if (!error) _latency.record(elapsed);
+
+        _rows = rows;
+        if (stats::enabled()) {
+            if (!_fingerprint || sql != _sql) {
+                _sql         = sql;
+                _normalized  = stats::normalize(sql);
+                _fingerprint = stats::fingerprint(_normalized);
+            }
+
+            uint64_t bytes = sql.length();
+            for (uint32_t n = 0; bind && n < bind->size(); n++) bytes += (*bind)[n].value.length();
+            stats::record(_fingerprint, _normalized, elapsed, rows, bytes, error);
+        }
+
+        uint64_t dropped;
+        if (isSlow(elapsed) && admitSlowQuery(dropped))
+            slowQuery(bind ? formatParams(sql, *bind) : sql, elapsed, rows, error, dropped);
+        if (observed()) notifyExecuteEnd(this, sql, rows, elapsed, error);
+    }
+
+    void Handle::slowQuery(string sql, uint64_t elapsed, uint32_t rows, bool error, uint64_t dropped) {
+        SlowQuery query;
+        query.sql     = sql;
+        query.rows    = rows;
+        query.elapsed = elapsed;
+        query.error   = error;
+        query.driver  = h->driver();
+        query.dbname  = _dbname;
+        query.host    = _host;
+        logSlowQuery(query, dropped);
+    }
+
+    void Handle::slowQueryThreshold(double threshold) {
+        _slow_threshold = threshold > 0 ? (uint64_t)(threshold * 1000000) : 0;
     }
 
     uint32_t Handle::execute(string sql) {
+        uint32_t rows;
         if (_trace) logMessage(_trace_fd, sql);
-        return h->execute(sql);
+        if (observed()) notifyExecuteStart(this, sql);
+        if (_phase_timing) phaseBegin(&_context->phases, &_context->totals);
+        uint64_t start = monotonicTime();
+        try {
+            rows = h->execute(sql);
+        }
+        catch (...) {
+            record(sql, 0, monotonicTime() - start, 0, true);
+            throw;
+        }
+        record(sql, 0, monotonicTime() - start, rows, false);
+        return rows;
     }
 
     uint32_t Handle::execute(string sql, param_list_t &bind) {
+        uint32_t rows;
         if (_trace) logMessage(_trace_fd, sql);
-        return h->execute(sql, bind);
+        if (observed()) notifyExecuteStart(this, sql);
+        if (_phase_timing) phaseBegin(&_context->phases, &_context->totals);
+        uint64_t start = monotonicTime();
+        try {
+            rows = h->execute(sql, bind);
+        }
+        catch (...) {
+            record(sql, &bind, monotonicTime() - start, 0, true);
+            throw;
+        }
+        record(sql, &bind, monotonicTime() - start, rows, false);
+        return rows;
     }
 
     Result* Handle::aexecute(string sql) {
+        AbstractResult *rs;
         if (_trace) logMessage(_trace_fd, sql);
-        return new Result(h->aexecute(sql));
+        metrics::add(DBI_METRIC_QUERIES);
+        try {
+            rs = h->aexecute(sql);
+        }
+        catch (...) {
+            metrics::error();
+            throw;
+        }
+
+        Result *instance = new Result(rs);
+        instance->inFlight();
+        return instance;
     }
 
     Result* Handle::aexecute(string sql, param_list_t &bind) {
+        AbstractResult *rs;
         if (_trace) logMessage(_trace_fd, sql);
-        return new Result(h->aexecute(sql, bind));
+        metrics::add(DBI_METRIC_QUERIES);
+        try {
+            rs = h->aexecute(sql, bind);
+        }
+        catch (...) {
+            metrics::error();
+            throw;
+        }
+
+        Result *instance = new Result(rs);
+        instance->inFlight();
+        return instance;
     }
 
     int Handle::socket() {
@@ -52,16 +180,19 @@ namespace dbi {
     }
 
     Result* Handle::result() {
-        return new Result(h->result());
+        Result *instance = new Result(h->result());
+        instance->attach(_context);
+        if (_fingerprint && stats::enabled()) instance->track(_fingerprint, _rows);
+        return instance;
     }
 
     Statement* Handle::prepare(string sql) {
-        return new Statement(h->prepare(sql));
+        return new Statement(this, sql);
     }
 
     // syntactic sugar.
     Statement* Handle::operator<<(string sql) {
-        return new Statement(h->prepare(sql));
+        return new Statement(this, sql);
     }
 
     bool Handle::begin() {
@@ -100,6 +231,8 @@ namespace dbi {
     }
 
     bool Handle::close() {
+        if (_open) metrics::add(DBI_METRIC_CONNECTIONS_CLOSED);
+        _open = false;
         return h->close();
     }
 
@@ -107,8 +240,112 @@ namespace dbi {
         return trx;
     }
 
+    // counts bytes handed to a driver bulk write, for observers.
+    class ObservedIO : public IO {
+        protected:
+        IO *io;
+
+        public:
+        uint64_t bytes;
+
+        ObservedIO(IO *i) : io(i), bytes(0) {}
+
+        string& read() {
+            string &data = io->read();
+            bytes += data.length();
+            return data;
+        }
+
+        uint32_t read(char *buffer, uint32_t len) {
+            uint32_t n = io->read(buffer, len);
+            bytes += n;
+            return n;
+        }
+
+        uint64_t read(const char **data, uint64_t len) {
+            uint64_t n = io->read(data, len);
+            bytes += n;
+            return n;
+        }
+
+        bool readline(string &line) {
+            bool found = io->readline(line);
+            if (found) bytes += line.length() + 1;
+            return found;
+        }
+
+        char* readline() {
+            char *line = io->readline();
+            if (line) bytes += strlen(line) + 1;
+            return line;
+        }
+
+        void write(const char *data)               { io->write(data); }
+        void write(const char *data, uint64_t len) { io->write(data, len); }
+        void truncate()                            { io->truncate(); }
+    };
+
+    class ObservedRows : public RowSource {
+        protected:
+        RowSource &source;
+
+        public:
+        uint64_t bytes;
+
+        ObservedRows(RowSource &s) : source(s), bytes(0) {}
+
+        ResultRow* next() {
+            ResultRow *row = source.next();
+            for (uint32_t n = 0; row && n < row->size(); n++) bytes += (*row)[n].value.length();
+            return row;
+        }
+    };
+
     uint64_t Handle::write(string table, field_list_t &fields, IO* io) {
-        return h->write(table, fields, io);
+        if (!observed()) {
+            uint64_t rows = h->write(table, fields, io);
+            metrics::add(DBI_METRIC_ROWS_WRITTEN, rows);
+            return rows;
+        }
+
+        ObservedIO observed_io(io);
+        uint64_t rows = h->write(table, fields, &observed_io);
+        metrics::add(DBI_METRIC_ROWS_WRITTEN, rows);
+        notifyBulkWrite(this, table, observed_io.bytes, rows);
+        return rows;
+    }
+
+    uint64_t Handle::write(string table, field_list_t &fields, row_list_t &rows) {
+        if (!observed()) {
+            uint64_t written = h->write(table, fields, rows);
+            metrics::add(DBI_METRIC_ROWS_WRITTEN, written);
+            return written;
+        }
+
+        uint64_t bytes = 0, written = h->write(table, fields, rows);
+        metrics::add(DBI_METRIC_ROWS_WRITTEN, written);
+        for (uint64_t r = 0; r < rows.size(); r++)
+            for (uint32_t n = 0; n < rows[r].size(); n++) bytes += rows[r][n].value.length();
+        notifyBulkWrite(this, table, bytes, written);
+        return written;
+    }
+
+    uint64_t Handle::writeRows(string table, field_list_t &fields, RowSource &source) {
+        if (!observed()) {
+            uint64_t rows = h->writeRows(table, fields, source);
+            metrics::add(DBI_METRIC_ROWS_WRITTEN, rows);
+            return rows;
+        }
+
+        ObservedRows observed_rows(source);
+        uint64_t rows = h->writeRows(table, fields, observed_rows);
+        metrics::add(DBI_METRIC_ROWS_WRITTEN, rows);
+        notifyBulkWrite(this, table, observed_rows.bytes, rows);
+        return rows;
+    }
+
+    uint64_t Handle::read(string table_or_query, field_list_t &fields, IO* io) {
+        return h->read(table_or_query, fields, io);
     }
 
     void Handle::setTimeZoneOffset(int tzhour, int tzmin) {
@@ -129,5 +366,39 @@ namespace dbi {
 
     void Handle::reconnect() {
         h->reconnect();
+        if (!_open) metrics::add(DBI_METRIC_CONNECTIONS_OPENED);
+        _open = true;
+        if (observed()) notifyReconnect(this);
+    }
+
+    Histogram& Handle::latency() {
+        return _latency;
+    }
+
+    Histogram& Handle::fetchLatency() {
+        return _context->fetchLatency();
+    }
+
+    PhaseTimes& Handle::phases() {
+        return _context->phases;
+    }
+
+    PhaseTimes& Handle::phaseTotals() {
+        return _context->totals;
+    }
+
+    void Handle::observe(Observer *observer) {
+        observer_list_t &local = _context->observers;
+        if (find(local.begin(), local.end(), observer) == local.end())
+            local.push_back(observer);
+    }
+
+    void Handle::unobserve(Observer *observer) {
+        observer_list_t &local = _context->observers;
+        local.erase(remove(local.begin(), local.end(), observer), local.end());
+    }
+
+    observer_list_t& Handle::observers() {
+        return _context->observers;
     }
 }
@@ -0,0 +1,118 @@
+#include "dbic++.h"
+
+// values below 64 have their own bucket, every power of two above is split into 32 buckets.
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_MAX_BITS 40
+#define HISTOGRAM_BUCKETS  ((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS)
+
+namespace dbi {
+
+    static inline uint32_t HISTOGRAM_INDEX(uint64_t value) {
+        if (value < (2 << HISTOGRAM_SUB_BITS)) return value;
+        if (value >> HISTOGRAM_MAX_BITS) return HISTOGRAM_BUCKETS - 1;
+
+        int shift = 63 - __builtin_clzll(value) - HISTOGRAM_SUB_BITS;
+        return (shift << HISTOGRAM_SUB_BITS) + (value >> shift);
+    }
+
+    // largest value that maps to the bucket.
+    static inline uint64_t HISTOGRAM_VALUE(uint32_t index) {
+        if (index < (2 << HISTOGRAM_SUB_BITS)) return index;
+
+        int shift = (index >> HISTOGRAM_SUB_BITS) - 1;
+        uint64_t sub = (1 << HISTOGRAM_SUB_BITS) + (index & ((1 << HISTOGRAM_SUB_BITS) - 1));
+        return ((sub + 1) << shift) - 1;
+    }
+
+    uint64_t monotonicTime() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+    }
+
+    Histogram::Histogram() {
+        buckets = 0;
+        _count  = _sum = _max = 0;
+        _min    = ~(uint64_t)0;
+    }
+
+    Histogram::~Histogram() {
+        if (buckets) free(buckets);
+    }
+
+    uint64_t* Histogram::allocate() {
+        uint64_t *fresh = (uint64_t*)calloc(HISTOGRAM_BUCKETS, sizeof(uint64_t)), *expected = 0;
+        if (!fresh) throw RuntimeError("Histogram: out of memory");
+
+        // another thread may have won the race.
+        if (!__atomic_compare_exchange_n(&buckets, &expected, fresh, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            free(fresh);
+            return expected;
+        }
+        return fresh;
+    }
+
+    void Histogram::record(uint64_t value) {
+        uint64_t *b = __atomic_load_n(&buckets, __ATOMIC_ACQUIRE);
+        if (!b) b = allocate();
+
+        __atomic_add_fetch(&b[HISTOGRAM_INDEX(value)], 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&_count, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&_sum, value, __ATOMIC_RELAXED);
+
+        uint64_t current = __atomic_load_n(&_min, __ATOMIC_RELAXED);
+        while (value < current && !__atomic_compare_exchange_n(&_min, &current, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+        current = __atomic_load_n(&_max, __ATOMIC_RELAXED);
+        while (value > current && !__atomic_compare_exchange_n(&_max, &current, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    }
+
+    uint64_t Histogram::count() {
+        return __atomic_load_n(&_count, __ATOMIC_RELAXED);
+    }
+
+    uint64_t Histogram::percentile(double p) {
+        uint64_t *b = __atomic_load_n(&buckets, __ATOMIC_ACQUIRE);
+        if (!b) return 0;
+
+        uint64_t total = 0;
+        for (uint32_t n = 0; n < HISTOGRAM_BUCKETS; n++) total += __atomic_load_n(&b[n], __ATOMIC_RELAXED);
+        if (total == 0) return 0;
+
+        p = p < 0 ? 0 : p > 100 ? 100 : p;
+        uint64_t rank = (uint64_t)(p / 100.0 * total + 0.5), seen = 0;
+        if (rank == 0) rank = 1;
+
+        uint64_t max = __atomic_load_n(&_max, __ATOMIC_RELAXED);
+        for (uint32_t n = 0; n < HISTOGRAM_BUCKETS; n++) {
+            seen += __atomic_load_n(&b[n], __ATOMIC_RELAXED);
+            if (seen >= rank) {
+                uint64_t value = HISTOGRAM_VALUE(n);
+                return value < max ? value : max;
+            }
+        }
+
+        return max;
+    }
+
+    LatencySnapshot Histogram::snapshot() {
+        LatencySnapshot s;
+
+        s.count = __atomic_load_n(&_count, __ATOMIC_RELAXED);
+        s.min   = s.count > 0 ? __atomic_load_n(&_min, __ATOMIC_RELAXED) : 0;
+        s.max   = __atomic_load_n(&_max, __ATOMIC_RELAXED);
+        s.mean  = s.count > 0 ? (double)__atomic_load_n(&_sum, __ATOMIC_RELAXED) / s.count : 0;
+        s.p50   = percentile(50);
+        s.p90   = percentile(90);
+        s.p99   = percentile(99);
+        s.p999  = percentile(99.9);
+
+        return s;
+    }
+
+    void Histogram::reset() {
+        if (buckets) memset(buckets, 0, HISTOGRAM_BUCKETS * sizeof(uint64_t));
+        _count = _sum = _max = 0;
+        _min   = ~(uint64_t)0;
+    }
+}
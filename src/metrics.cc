@@ -0,0 +1,133 @@
+#include "dbic++.h"
+
+namespace dbi {
+    namespace metrics {
+
+        // counters of one thread, only written by that thread.
+        struct Block {
+            uint64_t values[DBI_METRICS];
+            Block *prev, *next;
+        };
+
+        static pthread_mutex_t metrics_lock = PTHREAD_MUTEX_INITIALIZER;
+        static pthread_once_t  metrics_once = PTHREAD_ONCE_INIT;
+        static pthread_key_t   metrics_key;
+        static Block          *blocks = 0;
+        static uint64_t        retired[DBI_METRICS];
+
+        static __thread Block *block = 0;
+
+        // folds the block of an exiting thread into the retired totals.
+        static void METRICS_RETIRE(void *data) {
+            Block *b = (Block*)data;
+
+            pthread_mutex_lock(&metrics_lock);
+            for (int n = 0; n < DBI_METRICS; n++) retired[n] += b->values[n];
+            if (b->prev) b->prev->next = b->next;
+            else blocks = b->next;
+            if (b->next) b->next->prev = b->prev;
+            pthread_mutex_unlock(&metrics_lock);
+
+            if (block == b) block = 0;
+            free(b);
+        }
+
+        static void METRICS_KEY() {
+            pthread_key_create(&metrics_key, METRICS_RETIRE);
+        }
+
+        static Block* METRICS_BLOCK() {
+            pthread_once(&metrics_once, METRICS_KEY);
+
+            Block *b = (Block*)calloc(1, sizeof(Block));
+            if (!b) throw RuntimeError("Unable to allocate metrics");
+
+            pthread_mutex_lock(&metrics_lock);
+            b->next = blocks;
+            if (blocks) blocks->prev = b;
+            blocks = b;
+            pthread_mutex_unlock(&metrics_lock);
+
+            pthread_setspecific(metrics_key, b);
+            return block = b;
+        }
+
+        void add(int metric, int64_t n) {
+            Block *b = block ? block : METRICS_BLOCK();
+            __atomic_store_n(&b->values[metric], b->values[metric] + (uint64_t)n, __ATOMIC_RELAXED);
+        }
+
+        void error() {
+            try {
+                throw;
+            }
+            catch (ConnectionError &e) {
+                add(DBI_METRIC_CONNECTION_ERRORS);
+            }
+            catch (...) {
+                add(DBI_METRIC_RUNTIME_ERRORS);
+            }
+        }
+
+        static void METRICS_SUM(uint64_t *values) {
+            pthread_mutex_lock(&metrics_lock);
+            for (int n = 0; n < DBI_METRICS; n++) values[n] = retired[n];
+            for (Block *b = blocks; b; b = b->next)
+                for (int n = 0; n < DBI_METRICS; n++) values[n] += __atomic_load_n(&b->values[n], __ATOMIC_RELAXED);
+            pthread_mutex_unlock(&metrics_lock);
+        }
+
+        int64_t value(int metric) {
+            uint64_t values[DBI_METRICS];
+            METRICS_SUM(values);
+            return (int64_t)values[metric];
+        }
+
+        static void METRICS_FAMILY(string &out, const char *name, const char *type, const char *help) {
+            out += string("# HELP ") + name + " " + help + "\n";
+            out += string("# TYPE ") + name + " " + type + "\n";
+        }
+
+        static void METRICS_SAMPLE(string &out, const char *name, const char *labels, int64_t value) {
+            char buffer[256];
+            snprintf(buffer, 256, "%s%s %lld\n", name, labels, (long long)value);
+            out += buffer;
+        }
+
+        string prometheus() {
+            string out;
+            uint64_t values[DBI_METRICS];
+            METRICS_SUM(values);
+
+            METRICS_FAMILY(out, "dbi_connections_opened_total", "counter", "Connections opened.");
+            METRICS_SAMPLE(out, "dbi_connections_opened_total", "", values[DBI_METRIC_CONNECTIONS_OPENED]);
+            METRICS_FAMILY(out, "dbi_connections_closed_total", "counter", "Connections closed.");
+            METRICS_SAMPLE(out, "dbi_connections_closed_total", "", values[DBI_METRIC_CONNECTIONS_CLOSED]);
+            METRICS_FAMILY(out, "dbi_connections_open", "gauge", "Connections currently open.");
+            METRICS_SAMPLE(out, "dbi_connections_open", "",
+                (int64_t)(values[DBI_METRIC_CONNECTIONS_OPENED] - values[DBI_METRIC_CONNECTIONS_CLOSED]));
+            METRICS_FAMILY(out, "dbi_reconnects_total", "counter", "Successful reconnects.");
+            METRICS_SAMPLE(out, "dbi_reconnects_total", "", values[DBI_METRIC_RECONNECTS]);
+            METRICS_FAMILY(out, "dbi_queries_total", "counter", "Queries executed.");
+            METRICS_SAMPLE(out, "dbi_queries_total", "", values[DBI_METRIC_QUERIES]);
+            METRICS_FAMILY(out, "dbi_errors_total", "counter", "Errors raised by class.");
+            METRICS_SAMPLE(out, "dbi_errors_total", "{class=\"ConnectionError\"}", values[DBI_METRIC_CONNECTION_ERRORS]);
+            METRICS_SAMPLE(out, "dbi_errors_total", "{class=\"RuntimeError\"}", values[DBI_METRIC_RUNTIME_ERRORS]);
+            METRICS_FAMILY(out, "dbi_rows_read_total", "counter", "Rows read from results.");
+            METRICS_SAMPLE(out, "dbi_rows_read_total", "", values[DBI_METRIC_ROWS_READ]);
+            METRICS_FAMILY(out, "dbi_bytes_read_total", "counter", "Bytes of values read from results.");
+            METRICS_SAMPLE(out, "dbi_bytes_read_total", "", values[DBI_METRIC_BYTES_READ]);
+            METRICS_FAMILY(out, "dbi_bulk_rows_written_total", "counter", "Rows written by bulk writes.");
+            METRICS_SAMPLE(out, "dbi_bulk_rows_written_total", "", values[DBI_METRIC_ROWS_WRITTEN]);
+            METRICS_FAMILY(out, "dbi_async_queries_in_flight", "gauge", "Async queries not yet retrieved.");
+            METRICS_SAMPLE(out, "dbi_async_queries_in_flight", "", (int64_t)values[DBI_METRIC_ASYNC_IN_FLIGHT]);
+
+            return out;
+        }
+
+        void prometheus(IO *io) {
+            string out = prometheus();
+            io->write(out.data(), out.length());
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#include "dbic++.h"
+#include <sys/mman.h>
+
+namespace dbi {
+    MmapIO::MmapIO(const char *path) {
+        int fd;
+        struct stat st;
+
+        data = 0;
+        size = rpos = 0;
+
+        if ((fd = open(path, O_RDONLY)) < 0)
+            throw RuntimeError(strerror(errno));
+
+        if (fstat(fd, &st) < 0) {
+            close(fd);
+            throw RuntimeError(strerror(errno));
+        }
+
+        size = st.st_size;
+
+        // empty files cannot be mapped, they simply read as eof.
+        if (size > 0) {
+#ifdef POSIX_FADV_SEQUENTIAL
+            posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+            void *map = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map == MAP_FAILED) {
+                close(fd);
+                throw RuntimeError(strerror(errno));
+            }
+            data = (char*)map;
+            madvise(data, size, MADV_SEQUENTIAL);
+            madvise(data, size, MADV_WILLNEED);
+        }
+
+        close(fd);
+    }
+
+    MmapIO::~MmapIO() {
+        if (data) munmap(data, size);
+        data = 0;
+        size = rpos = 0;
+    }
+
+    string& MmapIO::read() {
+        const char *chunk;
+        uint64_t len = read(&chunk, 16384);
+        if (len > 0) {
+            stringdata = string(chunk, len);
+            return stringdata;
+        }
+        return empty;
+    }
+
+    uint32_t MmapIO::read(char *buffer, uint32_t len) {
+        const char *chunk = 0;
+        if ((len = read(&chunk, len)) > 0)
+            memcpy(buffer, chunk, len);
+        return len;
+    }
+
+    uint64_t MmapIO::read(const char **buffer, uint64_t len) {
+        if (rpos < size) {
+            uint64_t max = size - rpos;
+            len     = len > max ? max : len;
+            *buffer = data + rpos;
+            rpos   += len;
+            return len;
+        }
+        return 0;
+    }
+
+    void MmapIO::write(const char *) {
+        throw RuntimeError("MmapIO::write is not implemented");
+    }
+
+    void MmapIO::write(const char *, uint64_t) {
+        throw RuntimeError("MmapIO::write is not implemented");
+    }
+
+    void MmapIO::truncate() {
+        // NOP
+    }
+
+    bool MmapIO::readline(string &line) {
+        if (rpos < size) {
+            char *start = data + rpos, *end = (char*)memchr(start, '\n', size - rpos);
+            uint64_t len = end ? end - start : size - rpos;
+
+            line.assign(start, len);
+            rpos += end ? len + 1 : len;
+            return true;
+        }
+        return false;
+    }
+
+    char* MmapIO::readline() {
+        return readline(stringdata) ? (char*)stringdata.c_str() : 0;
+    }
+}
@@ -0,0 +1,66 @@
+#include "dbic++.h"
+#include <algorithm>
+
+namespace dbi {
+
+    // any process wide observers, checked before dispatching.
+    bool _observed = false;
+
+    static observer_list_t  observers;
+    static pthread_rwlock_t observers_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+    void addObserver(Observer *observer) {
+        pthread_rwlock_wrlock(&observers_lock);
+        if (find(observers.begin(), observers.end(), observer) == observers.end())
+            observers.push_back(observer);
+        _observed = true;
+        pthread_rwlock_unlock(&observers_lock);
+    }
+
+    void removeObserver(Observer *observer) {
+        pthread_rwlock_wrlock(&observers_lock);
+        observers.erase(remove(observers.begin(), observers.end(), observer), observers.end());
+        _observed = observers.size() > 0;
+        pthread_rwlock_unlock(&observers_lock);
+    }
+
+    // calls a member of every observer, process wide ones under the read lock.
+#define OBSERVER_DISPATCH(handle, call)                                                 \
+    do {                                                                                \
+        if (_observed) {                                                                \
+            pthread_rwlock_rdlock(&observers_lock);                                     \
+            for (uint32_t n = 0; n < observers.size(); n++) observers[n]->call;         \
+            pthread_rwlock_unlock(&observers_lock);                                     \
+        }                                                                               \
+        if (handle) {                                                                   \
+            observer_list_t &local = handle->observers();                               \
+            for (uint32_t n = 0; n < local.size(); n++) local[n]->call;                 \
+        }                                                                               \
+    } while (0)
+
+    void notifyConnect(Handle *handle) {
+        OBSERVER_DISPATCH(handle, onConnect(handle));
+    }
+
+    void notifyReconnect(Handle *handle) {
+        OBSERVER_DISPATCH(handle, onReconnect(handle));
+    }
+
+    void notifyExecuteStart(Handle *handle, string &sql) {
+        OBSERVER_DISPATCH(handle, onExecuteStart(handle, sql));
+    }
+
+    void notifyExecuteEnd(Handle *handle, string &sql, uint32_t rows, uint64_t elapsed, bool error) {
+        OBSERVER_DISPATCH(handle, onExecuteEnd(handle, sql, rows, elapsed, error));
+    }
+
+    void notifyBulkWrite(Handle *handle, string &table, uint64_t bytes, uint64_t rows) {
+        OBSERVER_DISPATCH(handle, onBulkWrite(handle, table, bytes, rows));
+    }
+
+    // the context outlives the handle, per handle observers are skipped once it is gone.
+    void notifyResultFetched(FetchContext *context, uint64_t rows, uint64_t bytes) {
+        Handle *handle = context ? context->source() : 0;
+        OBSERVER_DISPATCH(handle, onResultFetched(handle, rows, bytes));
+    }
+}
@@ -0,0 +1,374 @@
+#include "dbic++.h"
+
+// input is cut into chunks of roughly this size, each shard has up to
+// PARALLEL_LOADER_QUEUE chunks queued.
+#define PARALLEL_LOADER_CHUNK 1048576
+#define PARALLEL_LOADER_QUEUE 2
+
+namespace dbi {
+
+    // feeds the chunks queued for a shard to Handle::write.
+    class ParallelLoader::ShardIO : public IO {
+        protected:
+        ParallelLoader *loader;
+        Shard *shard;
+        Chunk *current;
+        string stringdata, empty;
+
+        bool next() {
+            if (current) loader->release(current);
+            current = loader->take(shard);
+            if (!current && loader->_aborted)
+                throw RuntimeError("ParallelLoader: aborted, error reading input");
+            return current != 0;
+        }
+
+        public:
+        ShardIO(ParallelLoader *l, Shard *s) : loader(l), shard(s), current(0) {}
+        ~ShardIO() {
+            if (current) loader->release(current);
+        }
+
+        uint64_t read(const char **data, uint64_t len) {
+            while (!current || current->rpos == current->data.length()) {
+                if (!next()) return 0;
+            }
+
+            uint64_t max = current->data.length() - current->rpos;
+            len   = len > max ? max : len;
+            *data = current->data.data() + current->rpos;
+            current->rpos += len;
+            return len;
+        }
+
+        uint32_t read(char *buffer, uint32_t size) {
+            const char *chunk;
+            uint32_t len, total = 0;
+
+            while (total < size && (len = read(&chunk, size - total)) > 0) {
+                memcpy(buffer + total, chunk, len);
+                total += len;
+            }
+
+            return total;
+        }
+
+        string& read() {
+            const char *chunk;
+            uint64_t len = read(&chunk, 16384);
+            if (len > 0) {
+                stringdata = string(chunk, len);
+                return stringdata;
+            }
+            return empty;
+        }
+
+        // chunks always end on a row boundary.
+        bool readline(string &line) {
+            const char *start, *end;
+
+            while (!current || current->rpos == current->data.length()) {
+                if (!next()) return false;
+            }
+
+            start = current->data.data() + current->rpos;
+            end   = (const char*)memchr(start, '\n', current->data.length() - current->rpos);
+            if (!end) end = current->data.data() + current->data.length();
+
+            line.assign(start, end - start);
+            current->rpos = end - current->data.data() + (end < current->data.data() + current->data.length() ? 1 : 0);
+            return true;
+        }
+
+        char* readline() {
+            return readline(stringdata) ? (char*)stringdata.c_str() : 0;
+        }
+
+        void write(const char *) {
+            throw RuntimeError("ParallelLoader::ShardIO::write is not implemented");
+        }
+
+        void write(const char *, uint64_t) {
+            throw RuntimeError("ParallelLoader::ShardIO::write is not implemented");
+        }
+
+        void truncate() {
+            // NOP
+        }
+    };
+
+    ParallelLoader::ParallelLoader(string driver, string user, string pass, string dbname,
+        string host, string port, char *options) {
+        _driver       = driver;
+        _user         = user;
+        _pass         = pass;
+        _dbname       = dbname;
+        _host         = host;
+        _port         = port;
+        _options      = options ? options : "";
+        _shards       = 4;
+        _transactions = false;
+        _rows         = 0;
+        _fields       = 0;
+        _aborted      = false;
+
+        pthread_mutex_init(&lock, 0);
+        pthread_cond_init(&cond, 0);
+    }
+
+    ParallelLoader::~ParallelLoader() {
+        cleanup();
+        pthread_mutex_destroy(&lock);
+        pthread_cond_destroy(&cond);
+    }
+
+    void ParallelLoader::shards(int n) {
+        _shards = n > 0 ? n : 1;
+    }
+
+    void ParallelLoader::transactions(bool flag) {
+        _transactions = flag;
+    }
+
+    uint64_t ParallelLoader::rows() {
+        return _rows;
+    }
+
+    string_list_t& ParallelLoader::errors() {
+        return _errors;
+    }
+
+    void ParallelLoader::cleanup() {
+        for (uint32_t n = 0; n < shards_list.size(); n++) {
+            delete shards_list[n]->io;
+            delete shards_list[n]->handle;
+            delete shards_list[n];
+        }
+        for (uint32_t n = 0; n < chunks.size(); n++)
+            delete chunks[n];
+
+        shards_list.clear();
+        chunks.clear();
+        idle.clear();
+    }
+
+    // waits for a free chunk, returns 0 if every shard has failed.
+    ParallelLoader::Chunk* ParallelLoader::acquire() {
+        Chunk *chunk = 0;
+        pthread_mutex_lock(&lock);
+        while (true) {
+            bool alive = false;
+            for (uint32_t n = 0; n < shards_list.size(); n++)
+                alive = alive || !shards_list[n]->failed;
+
+            if (!alive || !idle.empty()) break;
+            pthread_cond_wait(&cond, &lock);
+        }
+        if (!idle.empty()) {
+            chunk = idle.front();
+            idle.pop_front();
+        }
+        pthread_mutex_unlock(&lock);
+        return chunk;
+    }
+
+    // queues a chunk on the live shard with the shortest queue.
+    bool ParallelLoader::dispatch(Chunk *chunk) {
+        Shard *shard = 0;
+        chunk->rpos  = 0;
+
+        pthread_mutex_lock(&lock);
+        for (uint32_t n = 0; n < shards_list.size(); n++) {
+            Shard *s = shards_list[n];
+            if (!s->failed && (!shard || s->queue.size() < shard->queue.size()))
+                shard = s;
+        }
+        if (shard)
+            shard->queue.push_back(chunk);
+        else
+            idle.push_back(chunk);
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&lock);
+
+        return shard != 0;
+    }
+
+    // next chunk for a shard, 0 once the input is exhausted.
+    ParallelLoader::Chunk* ParallelLoader::take(Shard *shard) {
+        Chunk *chunk = 0;
+        pthread_mutex_lock(&lock);
+        while (shard->queue.empty() && !shard->closed)
+            pthread_cond_wait(&cond, &lock);
+        if (!shard->queue.empty()) {
+            chunk = shard->queue.front();
+            shard->queue.pop_front();
+        }
+        pthread_mutex_unlock(&lock);
+        return chunk;
+    }
+
+    void ParallelLoader::release(Chunk *chunk) {
+        pthread_mutex_lock(&lock);
+        chunk->data.clear();
+        idle.push_back(chunk);
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&lock);
+    }
+
+    void* ParallelLoader::worker(void *arg) {
+        Shard *shard = (Shard*)arg;
+        shard->loader->run(shard);
+        return 0;
+    }
+
+    void ParallelLoader::run(Shard *shard) {
+        try {
+            if (_transactions) shard->handle->begin();
+            shard->rows = shard->handle->write(_table, *_fields, shard->io);
+            if (_transactions) shard->handle->commit();
+        }
+        catch (exception &e) {
+            shard->error = e.what();
+            try {
+                if (_transactions) shard->handle->rollback();
+            }
+            catch (...) {
+            }
+        }
+
+        // a failed shard takes no more chunks, the ones already queued are recycled.
+        Chunk *chunk;
+        pthread_mutex_lock(&lock);
+        if (!shard->error.empty()) {
+            shard->failed = true;
+            pthread_cond_broadcast(&cond);
+        }
+        pthread_mutex_unlock(&lock);
+
+        while ((chunk = take(shard)))
+            release(chunk);
+    }
+
+    uint64_t ParallelLoader::write(string table, FieldSet &fields, IO *io) {
+        char *options = _options.empty() ? 0 : (char*)_options.c_str();
+
+        cleanup();
+        _rows    = 0;
+        _aborted = false;
+        _table   = table;
+        _fields = &fields;
+        _errors.clear();
+
+        // connections are opened up front so that driver and client library
+        // initialization happens on this thread and connection errors surface here.
+        for (int n = 0; n < _shards; n++) {
+            Shard *shard   = new Shard;
+            shard->loader  = this;
+            shard->handle  = 0;
+            shard->io      = 0;
+            shard->closed  = false;
+            shard->failed  = false;
+            shard->rows    = 0;
+            shards_list.push_back(shard);
+
+            shard->handle = new Handle(_driver, _user, _pass, _dbname, _host, _port, options);
+            shard->io     = new ShardIO(this, shard);
+        }
+
+        for (int n = 0; n < _shards * PARALLEL_LOADER_QUEUE; n++) {
+            chunks.push_back(new Chunk);
+            idle.push_back(chunks.back());
+        }
+
+        int started = 0;
+        for (; started < _shards; started++) {
+            if (pthread_create(&shards_list[started]->thread, 0, worker, shards_list[started]) != 0)
+                break;
+        }
+
+        for (int n = started; n < _shards; n++) {
+            shards_list[n]->error  = "Unable to start thread";
+            shards_list[n]->failed = true;
+        }
+
+        // cut the input into chunks that end on a row boundary, the partial row at the
+        // end of a chunk is carried over to the next one.
+        string carry, error;
+        try {
+            bool eof = false;
+            while (!eof && started > 0) {
+                Chunk *chunk = acquire();
+                if (!chunk) break;
+
+                chunk->data.swap(carry);
+                carry.clear();
+
+                size_t boundary = string::npos;
+                while (!eof && (chunk->data.length() < PARALLEL_LOADER_CHUNK || boundary == string::npos)) {
+                    const char *data;
+                    uint64_t len = io->read(&data, PARALLEL_LOADER_CHUNK);
+                    if (len > 0)
+                        chunk->data.append(data, len);
+                    else {
+                        size_t size = chunk->data.length();
+                        chunk->data.resize(size + PARALLEL_LOADER_CHUNK);
+                        len = io->read(&chunk->data[size], PARALLEL_LOADER_CHUNK);
+                        chunk->data.resize(size + len);
+                    }
+
+                    eof      = len == 0;
+                    boundary = chunk->data.rfind('\n');
+                }
+
+                if (!eof && boundary + 1 < chunk->data.length()) {
+                    carry.assign(chunk->data, boundary + 1, string::npos);
+                    chunk->data.resize(boundary + 1);
+                }
+
+                if (chunk->data.empty())
+                    release(chunk);
+                else if (!dispatch(chunk))
+                    break;
+            }
+        }
+        catch (exception &e) {
+            error = e.what();
+        }
+
+        // shards still running fail and roll back if the input could not be read.
+        pthread_mutex_lock(&lock);
+        _aborted = !error.empty();
+        for (int n = 0; n < _shards; n++)
+            shards_list[n]->closed = true;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&lock);
+
+        for (int n = 0; n < started; n++)
+            pthread_join(shards_list[n]->thread, 0);
+
+        char message[64];
+        for (int n = 0; n < _shards; n++) {
+            Shard *shard = shards_list[n];
+            if (shard->error.empty())
+                _rows += shard->rows;
+            else {
+                snprintf(message, 64, "shard %d: ", n);
+                _errors.push_back(message + shard->error);
+            }
+        }
+
+        if (!error.empty())
+            _errors.push_back("input: " + error);
+
+        cleanup();
+
+        if (_errors.size() > 0) {
+            string summary = "ParallelLoader failed";
+            for (uint32_t n = 0; n < _errors.size(); n++)
+                summary += "\n  " + _errors[n];
+            throw RuntimeError(summary);
+        }
+
+        return _rows;
+    }
+}
@@ -22,7 +22,12 @@ namespace dbi {
     }
 
     Param PARAM_BINARY(unsigned char *data, uint64_t l) {
-        Param p = { false, data ? string((const char*)data, l) : "", true };
+        Param p = { false, data ? string((const char*)data, l) : "", true, DBI_TYPE_BLOB };
+        return p;
+    }
+
+    Param PARAM_TYPED(const char *s, int type) {
+        Param p = { false, s ? s : "", false, type };
         return p;
     }
 
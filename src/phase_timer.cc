@@ -0,0 +1,87 @@
+#include "dbic++.h"
+
+namespace dbi {
+
+    bool _phase_timing = false;
+
+    static const char *phase_names[DBI_PHASES] = { "preprocess", "bind", "send", "wait", "fetch", "decode" };
+
+    static uint64_t phase_executions = 0;
+    static uint64_t phase_totals[DBI_PHASES];
+
+    // execution in progress on this thread, targets are last, totals and parent totals.
+    static __thread PhaseTimes *phase_targets[3];
+    static __thread uint64_t    phase_mark;
+
+    PhaseTimes::PhaseTimes() {
+        reset();
+    }
+
+    void PhaseTimes::reset() {
+        executions = 0;
+        memset(time, 0, sizeof(time));
+    }
+
+    void phaseTiming(bool flag) {
+        _phase_timing = flag;
+    }
+
+    const char* phaseName(int phase) {
+        return phase >= 0 && phase < DBI_PHASES ? phase_names[phase] : "unknown";
+    }
+
+    uint64_t phaseClock() {
+        struct timespec ts;
+#ifdef CLOCK_MONOTONIC_RAW
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+        return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+    }
+
+    PhaseTimes phaseTotals() {
+        PhaseTimes times;
+        times.executions = __atomic_load_n(&phase_executions, __ATOMIC_RELAXED);
+        for (int n = 0; n < DBI_PHASES; n++)
+            times.time[n] = __atomic_load_n(&phase_totals[n], __ATOMIC_RELAXED);
+        return times;
+    }
+
+    void resetPhaseTotals() {
+        __atomic_store_n(&phase_executions, 0, __ATOMIC_RELAXED);
+        for (int n = 0; n < DBI_PHASES; n++)
+            __atomic_store_n(&phase_totals[n], 0, __ATOMIC_RELAXED);
+    }
+
+    void phaseBegin(PhaseTimes *last, PhaseTimes *totals, PhaseTimes *parent) {
+        last->reset();
+        last->executions = 1;
+        totals->executions++;
+        if (parent) parent->executions++;
+        __atomic_fetch_add(&phase_executions, 1, __ATOMIC_RELAXED);
+
+        phase_targets[0] = last;
+        phase_targets[1] = totals;
+        phase_targets[2] = parent;
+        phase_mark       = phaseClock();
+    }
+
+    void phaseEnd() {
+        phase_targets[0] = phase_targets[1] = phase_targets[2] = 0;
+    }
+
+    void phaseAdd(PhaseTimes **times, int phase, uint64_t elapsed) {
+        for (int n = 0; n < 3; n++)
+            if (times[n]) times[n]->time[phase] += elapsed;
+        __atomic_fetch_add(&phase_totals[phase], elapsed, __ATOMIC_RELAXED);
+    }
+
+    void phaseMark(int phase) {
+        if (!phase_targets[0]) return;
+
+        uint64_t now = phaseClock();
+        phaseAdd(phase_targets, phase, now - phase_mark);
+        phase_mark = now;
+    }
+}
@@ -5,6 +5,10 @@ namespace dbi {
         rs = 0;
         h  = handle.h;
         st = h->prepare(sql);
+
+        this->handle     = &handle;
+        attach(fetchContext());
+        _fingerprint     = 0;
     }
 
     Query::~Query() {
@@ -20,6 +24,7 @@ namespace dbi {
     }
 
     void Query::finish() {
+        flushStats();
         if (rs) {
             delete rs;
             rs = 0;
@@ -78,20 +83,17 @@ namespace dbi {
 
     uint32_t Query::execute() {
         finish();
-        if (_trace)
-            logMessage(_trace_fd, formatParams(st->command(), params));
-        uint32_t rows = st->execute(params);
-        params.clear();
+        uint32_t rows = Statement::execute();
         rs = st->result();
+        if (_fingerprint && stats::enabled()) track(_fingerprint, rows);
         return rows;
     }
 
     uint32_t Query::execute(param_list_t &bind) {
         finish();
-        if (_trace)
-            logMessage(_trace_fd, formatParams(st->command(), bind));
-        uint32_t rows = st->execute(bind);
+        uint32_t rows = Statement::execute(bind);
         rs = st->result();
+        if (_fingerprint && stats::enabled()) track(_fingerprint, rows);
         return rows;
     }
 
@@ -106,6 +108,7 @@ namespace dbi {
         }
 
         st = h->prepare(sql);
+        resetTimes();
         return *this;
     }
 }
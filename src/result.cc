@@ -2,14 +2,66 @@
 
 namespace dbi {
 
-    Result::Result() { rs = 0; }
+    Result::Result() {
+        rs = 0;
+        context = 0;
+        in_flight = false;
+        fingerprint = fetched_rows = fetched_bytes = counted_rows = 0;
+    }
 
     Result::Result(AbstractResult *ars) {
         rs = ars; // :P
+        context = 0;
+        in_flight = false;
+        fingerprint = fetched_rows = fetched_bytes = counted_rows = 0;
+    }
+
+    // rows is the count already recorded at execute, only rows read beyond it are added.
+    void Result::track(uint64_t fp, uint64_t rows) {
+        flushStats();
+        fingerprint  = fp;
+        counted_rows = rows;
+    }
+
+    void Result::attach(FetchContext *c) {
+        if (context) context->release();
+        context = c ? c->retain() : 0;
+    }
+
+    void Result::flushStats() {
+        if (fingerprint && (fetched_bytes > 0 || fetched_rows > counted_rows))
+            stats::fetched(fingerprint, fetched_rows > counted_rows ? fetched_rows - counted_rows : 0, fetched_bytes);
+        if (fetched_rows > 0) {
+            metrics::add(DBI_METRIC_ROWS_READ,  fetched_rows);
+            metrics::add(DBI_METRIC_BYTES_READ, fetched_bytes);
+        }
+        if (fetched_rows > 0 && (_observed || (context && context->observed())))
+            notifyResultFetched(context, fetched_rows, fetched_bytes);
+        fingerprint = fetched_rows = fetched_bytes = counted_rows = 0;
+    }
+
+    void Result::inFlight() {
+        in_flight = true;
+        metrics::add(DBI_METRIC_ASYNC_IN_FLIGHT, 1);
+    }
+
+    void Result::landed() {
+        if (in_flight) metrics::add(DBI_METRIC_ASYNC_IN_FLIGHT, -1);
+        in_flight = false;
+    }
+
+    void Result::recordFetch(uint64_t elapsed) {
+        static PhaseTimes *none[3] = {0, 0, 0};
+
+        if (context)
+            context->recordFetch(elapsed);
+        else if (_phase_timing)
+            phaseAdd(none, DBI_PHASE_DECODE, elapsed);
     }
 
     Result::~Result() {
         cleanup();
+        if (context) context->release();
     }
 
     uint32_t Result::rows() {
@@ -19,15 +71,45 @@ namespace dbi {
 
     bool Result::read(ResultRow& r) {
         if (!rs) throw RuntimeError("Invalid Result instance");
-        return rs->read(r);
+        bool found;
+
+        if (!_phase_timing && !(context && context->timed()))
+            found = rs->read(r);
+        else {
+            uint64_t start = monotonicTime();
+            found = rs->read(r);
+            recordFetch(monotonicTime() - start);
+        }
+
+        if (found) {
+            fetched_rows++;
+            for (int n = 0; n < r.size(); n++) fetched_bytes += r[n].value.length();
+        }
+        return found;
     }
 
     bool Result::read(ResultRowHash &r) {
         if (!rs) throw RuntimeError("Invalid Result instance");
-        return rs->read(r);
+        bool found;
+
+        if (!_phase_timing && !(context && context->timed()))
+            found = rs->read(r);
+        else {
+            uint64_t start = monotonicTime();
+            found = rs->read(r);
+            recordFetch(monotonicTime() - start);
+        }
+
+        if (found) {
+            fetched_rows++;
+            fetched_bytes += r.bytes();
+        }
+        return found;
     }
 
     void Result::cleanup() {
+        flushStats();
+        landed();
         if (rs) {
             delete rs;
             rs = 0;
@@ -49,6 +131,11 @@ namespace dbi {
         return rs->read(r, c, l);
     }
 
+    bool Result::read(uint32_t r, uint32_t c, Value &v) {
+        if (!rs) throw RuntimeError("Invalid Result instance");
+        return rs->read(r, c, v);
+    }
+
     unsigned char* Result::operator()(uint32_t r, uint32_t c) {
         if (!rs) throw RuntimeError("Invalid Result instance");
         return rs->read(r, c, 0);
@@ -84,5 +171,6 @@ namespace dbi {
             printf("retr\n");
         }
         rs->prepareResult();
+        landed();
     }
 }
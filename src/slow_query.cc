@@ -0,0 +1,125 @@
+#include "dbic++.h"
+
+namespace dbi {
+
+    // ~0 disables the log, checked on every execute.
+    uint64_t _slow_query_threshold = ~(uint64_t)0;
+
+    // guards the sink and rate limit, never held while calling out. io writes are
+    // serialized on their own lock.
+    static pthread_mutex_t       slow_query_lock  = PTHREAD_MUTEX_INITIALIZER;
+    static pthread_mutex_t       slow_query_io_lock = PTHREAD_MUTEX_INITIALIZER;
+    static int                   slow_query_fd    = -1;
+    static IO                   *slow_query_io    = 0;
+    static slow_query_callback_t slow_query_cb    = 0;
+    static void                 *slow_query_data  = 0;
+
+    // rate limit, at most slow_query_limit queries in the current second.
+    static uint32_t slow_query_limit   = 10;
+    static uint32_t slow_query_logged  = 0;
+    static uint64_t slow_query_dropped = 0;
+    static time_t   slow_query_second  = 0;
+
+    static void SLOW_QUERY_SINK(double threshold, int fd, IO *io, slow_query_callback_t cb, void *data) {
+        pthread_mutex_lock(&slow_query_lock);
+        slow_query_fd   = fd;
+        slow_query_io   = io;
+        slow_query_cb   = cb;
+        slow_query_data = data;
+        _slow_query_threshold = threshold < 0 ? ~(uint64_t)0 : (uint64_t)(threshold * 1000000);
+        pthread_mutex_unlock(&slow_query_lock);
+    }
+
+    void slowQueryLog(double threshold, int fd) {
+        SLOW_QUERY_SINK(threshold, fd, 0, 0, 0);
+    }
+
+    void slowQueryLog(double threshold, IO *io) {
+        SLOW_QUERY_SINK(threshold, -1, io, 0, 0);
+    }
+
+    void slowQueryLog(double threshold, slow_query_callback_t callback, void *data) {
+        SLOW_QUERY_SINK(threshold, -1, 0, callback, data);
+    }
+
+    void slowQueryLogOff() {
+        SLOW_QUERY_SINK(-1, -1, 0, 0, 0);
+    }
+
+    void slowQueryRateLimit(uint32_t n) {
+        pthread_mutex_lock(&slow_query_lock);
+        slow_query_limit = n;
+        pthread_mutex_unlock(&slow_query_lock);
+    }
+
+    bool admitSlowQuery(uint64_t &dropped) {
+        time_t now = time(0);
+
+        pthread_mutex_lock(&slow_query_lock);
+
+        if (now != slow_query_second) {
+            slow_query_second = now;
+            slow_query_logged = 0;
+        }
+
+        if (slow_query_limit > 0 && slow_query_logged >= slow_query_limit) {
+            slow_query_dropped++;
+            pthread_mutex_unlock(&slow_query_lock);
+            return false;
+        }
+
+        slow_query_logged++;
+        dropped            = slow_query_dropped;
+        slow_query_dropped = 0;
+
+        pthread_mutex_unlock(&slow_query_lock);
+        return true;
+    }
+
+    void logSlowQuery(SlowQuery &query, uint64_t dropped) {
+        char prefix[1024];
+
+        pthread_mutex_lock(&slow_query_lock);
+        int fd                   = slow_query_fd;
+        IO *io                   = slow_query_io;
+        slow_query_callback_t cb = slow_query_cb;
+        void *data               = slow_query_data;
+        pthread_mutex_unlock(&slow_query_lock);
+
+        try {
+            if (cb) {
+                cb(query, data);
+            }
+            else if (fd >= 0 || io) {
+                snprintf(prefix, 1024, "SLOW %.3fms rows=%u driver=%s db=%s host=%s%s",
+                    query.elapsed / 1e6, query.rows, query.driver.c_str(), query.dbname.c_str(),
+                    query.host.c_str(), query.error ? " error" : "");
+
+                string line(prefix);
+                if (dropped > 0) {
+                    snprintf(prefix, 1024, " (%lu dropped)", (unsigned long)dropped);
+                    line += prefix;
+                }
+                line += ": " + query.sql;
+
+                if (io) {
+                    line += "\n";
+                    pthread_mutex_lock(&slow_query_io_lock);
+                    try {
+                        io->write(line.data(), line.length());
+                    }
+                    catch (...) {
+                        pthread_mutex_unlock(&slow_query_io_lock);
+                        throw;
+                    }
+                    pthread_mutex_unlock(&slow_query_io_lock);
+                }
+                else
+                    logMessage(fd, line);
+            }
+        }
+        catch (...) {
+            // a failing sink must not fail the query that was logged.
+        }
+    }
+}
@@ -3,36 +3,75 @@
 namespace dbi {
 
     Statement::Statement() {
-        st = 0;
-        h  = 0;
+        st     = 0;
+        h      = 0;
+        handle = 0;
+        _fingerprint = 0;
+        _latency     = 0;
+        _context     = 0;
     }
 
     Statement::Statement(AbstractStatement *ast) {
-        st = ast;
+        st     = ast;
+        h      = 0;
+        handle = 0;
+        _fingerprint = 0;
+        _latency     = 0;
+        _context     = 0;
     }
 
     Statement::Statement(Handle &handle) {
-        st = 0;
-        h  = handle.h;
+        st           = 0;
+        h            = handle.h;
+        this->handle = &handle;
+        _fingerprint = 0;
+        _latency     = 0;
+        _context     = 0;
     }
 
     Statement::Statement(Handle &handle, string sql) {
-        h  = handle.h;
-        st = h->prepare(sql);
+        h            = handle.h;
+        st           = h->prepare(sql);
+        this->handle = &handle;
+        _fingerprint = 0;
+        _latency     = 0;
+        _context     = 0;
     }
 
     Statement::Statement(Handle *handle) {
-        st = 0;
-        h  = handle->h;
+        st           = 0;
+        h            = handle->h;
+        this->handle = handle;
+        _fingerprint = 0;
+        _latency     = 0;
+        _context     = 0;
     }
 
     Statement::Statement(Handle *handle, string sql) {
-        h  = handle->h;
-        st = h->prepare(sql);
+        h            = handle->h;
+        st           = h->prepare(sql);
+        this->handle = handle;
+        _fingerprint = 0;
+        _latency     = 0;
+        _context     = 0;
     }
 
     Statement::~Statement() {
         cleanup();
+        delete _latency;
+        if (_context) _context->release();
+    }
+
+    // results of this statement share its context, fetch times also go to the handle.
+    FetchContext* Statement::fetchContext() {
+        if (!_context) _context = new FetchContext(handle ? handle->_context : 0);
+        return _context;
+    }
+
+    void Statement::resetTimes() {
+        if (_latency) _latency->reset();
+        if (_context) _context->reset();
+        _fingerprint = 0;
     }
 
     void Statement::finish() {
@@ -104,6 +143,7 @@ namespace dbi {
         if (st) delete st;
 
         st = h->prepare(sql);
+        resetTimes();
         return *this;
     }
 
@@ -114,28 +154,105 @@ namespace dbi {
     void Statement::bind(long v) {
         char val[256];
         sprintf(val, "%ld", v);
-        params.push_back(PARAM(val));
+        params.push_back(PARAM_TYPED(val, DBI_TYPE_INT));
     }
 
     void Statement::bind(double v) {
         char val[256];
         sprintf(val, "%lf", v);
-        params.push_back(PARAM(val));
+        params.push_back(PARAM_TYPED(val, DBI_TYPE_FLOAT));
+    }
+
+    // latencies of successful executions and statement statistics of all of them, called from
+    // the catch block on errors.
+    void Statement::record(uint64_t elapsed, uint32_t rows, param_list_t &bind, bool error) {
+        phaseEnd();
+        metrics::add(DBI_METRIC_QUERIES);
+        if (error) metrics::error();
+        if (!error) {
+            if (_latency) _latency->record(elapsed);
+            if (handle) handle->_latency.record(elapsed);
+        }
+
+        if (stats::enabled()) {
+            if (!_fingerprint) {
+                _normalized  = stats::normalize(st->command());
+                _fingerprint = stats::fingerprint(_normalized);
+            }
+
+            uint64_t bytes = st->command().length();
+            for (uint32_t n = 0; n < bind.size(); n++) bytes += bind[n].value.length();
+            stats::record(_fingerprint, _normalized, elapsed, rows, bytes, error);
+        }
+
+        uint64_t dropped;
+        if (handle) {
+            if (handle->isSlow(elapsed) && admitSlowQuery(dropped))
+                handle->slowQuery(formatParams(st->command(), bind), elapsed, rows, error, dropped);
+        }
+        else if (_slow_query_threshold != ~(uint64_t)0 && elapsed >= _slow_query_threshold && admitSlowQuery(dropped)) {
+            SlowQuery query;
+            query.sql     = formatParams(st->command(), bind);
+            query.rows    = rows;
+            query.elapsed = elapsed;
+            query.error   = error;
+            query.driver  = h ? h->driver() : "";
+            logSlowQuery(query, dropped);
+        }
+
+        if (observed()) {
+            string sql = st->command();
+            notifyExecuteEnd(handle, sql, rows, elapsed, error);
+        }
     }
 
     uint32_t Statement::execute() {
         uint32_t rc;
         if (_trace)
             logMessage(_trace_fd, formatParams(st->command(), params));
-        rc = st->execute(params);
+        if (observed()) {
+            string sql = st->command();
+            notifyExecuteStart(handle, sql);
+        }
+        if (_phase_timing) {
+            FetchContext *times = fetchContext();
+            phaseBegin(&times->phases, &times->totals, handle ? &handle->_context->totals : 0);
+        }
+        uint64_t start = monotonicTime();
+        try {
+            rc = st->execute(params);
+        }
+        catch (...) {
+            record(monotonicTime() - start, 0, params, true);
+            throw;
+        }
+        record(monotonicTime() - start, rc, params, false);
         params.clear();
         return rc;
     }
 
     uint32_t Statement::execute(param_list_t &bind) {
+        uint32_t rc;
         if (_trace)
             logMessage(_trace_fd, formatParams(st->command(), bind));
-        return st->execute(bind);
+        if (observed()) {
+            string sql = st->command();
+            notifyExecuteStart(handle, sql);
+        }
+        if (_phase_timing) {
+            FetchContext *times = fetchContext();
+            phaseBegin(&times->phases, &times->totals, handle ? &handle->_context->totals : 0);
+        }
+        uint64_t start = monotonicTime();
+        try {
+            rc = st->execute(bind);
+        }
+        catch (...) {
+            record(monotonicTime() - start, 0, bind, true);
+            throw;
+        }
+        record(monotonicTime() - start, rc, bind, false);
+        return rc;
     }
 
     uint32_t Statement::operator,(dbi::execute const &e) {
@@ -143,10 +260,30 @@ namespace dbi {
     }
 
     Result* Statement::result() {
-        return new Result(st->result());
+        Result *instance = new Result(st->result());
+        instance->attach(fetchContext());
+        if (_fingerprint && stats::enabled()) instance->track(_fingerprint, instance->rows());
+        return instance;
     }
 
     uint64_t Statement::lastInsertID() {
         return st->lastInsertID();
     }
+
+    Histogram& Statement::latency() {
+        if (!_latency) _latency = new Histogram();
+        return *_latency;
+    }
+
+    Histogram& Statement::fetchLatency() {
+        return fetchContext()->fetchLatency();
+    }
+
+    PhaseTimes& Statement::phases() {
+        return fetchContext()->phases;
+    }
+
+    PhaseTimes& Statement::phaseTotals() {
+        return fetchContext()->totals;
+    }
 }
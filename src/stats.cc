@@ -0,0 +1,209 @@
+#include "dbic++.h"
+#include <algorithm>
+
+// the table is split into stripes by fingerprint so that concurrent executions rarely share
+// a lock, each stripe keeps at most STATS_STRIPE_MAX fingerprints and ignores new ones after.
+#define STATS_STRIPES    16
+#define STATS_STRIPE_MAX 512
+
+namespace dbi {
+    namespace stats {
+
+        struct Stripe {
+            pthread_mutex_t lock;
+            map<uint64_t, Entry> entries;
+            Stripe() { pthread_mutex_init(&lock, 0); }
+        };
+
+        static bool   collect = false;
+        static Stripe stripes[STATS_STRIPES];
+
+        void enable(bool flag) {
+            collect = flag;
+        }
+
+        bool enabled() {
+            return collect;
+        }
+
+        static inline bool STATS_IDENTIFIER(char c) {
+            return isalnum((unsigned char)c) || c == '_' || c == '$';
+        }
+
+        // emits a placeholder, folding "?, ?" lists into a single "?".
+        static void STATS_PLACEHOLDER(string &out) {
+            uint64_t len = out.length();
+            if (len >= 3 && out.compare(len - 3, 3, "?, ") == 0)
+                out.erase(len - 2);
+            else if (len >= 2 && out.compare(len - 2, 2, "?,") == 0)
+                out.erase(len - 1);
+            else
+                out += '?';
+        }
+
+        string normalize(string sql) {
+            string out;
+            bool space   = false;
+            const char *p = sql.c_str(), *end = p + sql.length();
+
+            out.reserve(sql.length());
+
+            while (p < end) {
+                char c = *p;
+
+                if (isspace((unsigned char)c)) {
+                    space = true;
+                    p++;
+                    continue;
+                }
+
+                // comments separate tokens like whitespace.
+                if (c == '-' && p[1] == '-') {
+                    while (p < end && *p != '\n') p++;
+                    space = true;
+                    continue;
+                }
+                if (c == '/' && p[1] == '*') {
+                    const char *close = strstr(p + 2, "*/");
+                    p     = close ? close + 2 : end;
+                    space = true;
+                    continue;
+                }
+
+                if (space && out.length() > 0) out += ' ';
+                space = false;
+
+                // string literal, '' and backslash escapes stay inside.
+                if (c == '\'') {
+                    for (p++; p < end; p++) {
+                        if (*p == '\\' && p + 1 < end) p++;
+                        else if (*p == '\'') {
+                            if (p + 1 < end && p[1] == '\'') p++;
+                            else break;
+                        }
+                    }
+                    p++;
+                    STATS_PLACEHOLDER(out);
+                }
+                // quoted identifiers are kept as is.
+                else if (c == '"' || c == '`') {
+                    const char *close = (const char*)memchr(p + 1, c, end - p - 1);
+                    close = close ? close + 1 : end;
+                    out.append(p, close - p);
+                    p = close;
+                }
+                // numbers, unless part of an identifier.
+                else if ((isdigit((unsigned char)c) || (c == '.' && isdigit((unsigned char)p[1])))
+                    && (out.empty() || !STATS_IDENTIFIER(out[out.length() - 1]))) {
+                    for (p++; p < end; p++) {
+                        if ((*p == '+' || *p == '-') && (p[-1] == 'e' || p[-1] == 'E')) continue;
+                        if (!isalnum((unsigned char)*p) && *p != '.') break;
+                    }
+                    STATS_PLACEHOLDER(out);
+                }
+                // placeholders: ?, $1 and printf style %s, %d, %ld ...
+                else if (c == '?' || (c == '$' && isdigit((unsigned char)p[1]) && (out.empty() || !STATS_IDENTIFIER(out[out.length() - 1])))) {
+                    for (p++; p < end && isdigit((unsigned char)*p); p++);
+                    STATS_PLACEHOLDER(out);
+                }
+                else if (c == '%' && p + 1 < end && (strchr("dsfu", p[1]) || (p[1] == 'l' && p + 2 < end && strchr("dfu", p[2])))) {
+                    p += p[1] == 'l' ? 3 : 2;
+                    STATS_PLACEHOLDER(out);
+                }
+                else {
+                    out += tolower((unsigned char)c);
+                    p++;
+                }
+            }
+
+            // a trailing ; does not change the statement.
+            while (out.length() > 0 && (out[out.length() - 1] == ';' || out[out.length() - 1] == ' '))
+                out.erase(out.length() - 1);
+
+            return out;
+        }
+
+        // 64 bit FNV-1a.
+        uint64_t fingerprint(string normalized) {
+            uint64_t hash = 14695981039346656037ULL;
+            for (uint64_t n = 0; n < normalized.length(); n++) {
+                hash ^= (unsigned char)normalized[n];
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+
+        void record(uint64_t fingerprint, string &normalized, uint64_t elapsed, uint64_t rows, uint64_t bytes, bool error) {
+            Stripe &stripe = stripes[fingerprint % STATS_STRIPES];
+
+            pthread_mutex_lock(&stripe.lock);
+            map<uint64_t, Entry>::iterator it = stripe.entries.find(fingerprint);
+            if (it == stripe.entries.end()) {
+                if (stripe.entries.size() >= STATS_STRIPE_MAX) {
+                    pthread_mutex_unlock(&stripe.lock);
+                    return;
+                }
+
+                Entry &entry = stripe.entries[fingerprint];
+                entry.fingerprint = fingerprint;
+                entry.sql         = normalized;
+                entry.calls       = entry.errors = entry.total_time = entry.max_time = entry.rows = entry.bytes = 0;
+                it = stripe.entries.find(fingerprint);
+            }
+
+            Entry &entry = it->second;
+            entry.calls++;
+            entry.total_time += elapsed;
+            entry.rows       += rows;
+            entry.bytes      += bytes;
+            if (error) entry.errors++;
+            if (elapsed > entry.max_time) entry.max_time = elapsed;
+            pthread_mutex_unlock(&stripe.lock);
+        }
+
+        void fetched(uint64_t fingerprint, uint64_t rows, uint64_t bytes) {
+            Stripe &stripe = stripes[fingerprint % STATS_STRIPES];
+
+            pthread_mutex_lock(&stripe.lock);
+            map<uint64_t, Entry>::iterator it = stripe.entries.find(fingerprint);
+            if (it != stripe.entries.end()) {
+                it->second.rows  += rows;
+                it->second.bytes += bytes;
+            }
+            pthread_mutex_unlock(&stripe.lock);
+        }
+
+        static bool STATS_BY_TIME(const Entry &a, const Entry &b) {
+            return a.total_time > b.total_time;
+        }
+
+        entry_list_t top(int n) {
+            entry_list_t list;
+
+            for (int s = 0; s < STATS_STRIPES; s++) {
+                pthread_mutex_lock(&stripes[s].lock);
+                for (map<uint64_t, Entry>::iterator it = stripes[s].entries.begin(); it != stripes[s].entries.end(); it++)
+                    list.push_back(it->second);
+                pthread_mutex_unlock(&stripes[s].lock);
+            }
+
+            if (n < 0) n = 0;
+            if ((uint64_t)n < list.size()) {
+                partial_sort(list.begin(), list.begin() + n, list.end(), STATS_BY_TIME);
+                list.resize(n);
+            }
+            else
+                sort(list.begin(), list.end(), STATS_BY_TIME);
+
+            return list;
+        }
+
+        void reset() {
+            for (int s = 0; s < STATS_STRIPES; s++) {
+                pthread_mutex_lock(&stripes[s].lock);
+                stripes[s].entries.clear();
+                pthread_mutex_unlock(&stripes[s].lock);
+            }
+        }
+    }
+}
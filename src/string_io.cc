@@ -1,98 +1,226 @@
 #include "dbic++.h"
 
+// chunks grow from STRINGIO_MIN_CHUNK to STRINGIO_MAX_CHUNK as more data is written,
+// larger writes get a chunk of their own size.
+#define STRINGIO_MIN_CHUNK 4096
+#define STRINGIO_MAX_CHUNK 1048576
+
 namespace dbi {
+    void StringIO::init() {
+        head       = tail = current = spare = 0;
+        rpos       = 0;
+        chunk_size = STRINGIO_MIN_CHUNK;
+    }
+
     StringIO::StringIO() {
-        rpos   = 0;
-        wpos   = 0;
-        alloc  = 1024;
-        data   = (unsigned char*)malloc(alloc);
-        if (!data) throw RuntimeError("Out of memory: StringIO");
+        init();
     }
 
     StringIO::StringIO(const char *v, uint64_t size) {
-        rpos   = 0;
-        wpos   = 0;
-        alloc = size*2 + 1;
-        data   = (unsigned char*)malloc(alloc);
-        if (!data) throw RuntimeError("Out of memory: StringIO");
-        memcpy(data+wpos, v, size);
-        wpos += size;
+        init();
+        write(v, size);
+    }
+
+    StringIO::Chunk* StringIO::allocate(uint64_t size) {
+        Chunk *chunk;
+
+        if (spare && spare->size >= size) {
+            chunk = spare;
+            spare = 0;
+        }
+        else {
+            if (size < chunk_size) size = chunk_size;
+            if (!(chunk = (Chunk*)malloc(sizeof(Chunk) + size)))
+                throw RuntimeError("Out of memory: StringIO");
+            chunk->size = size;
+            if (chunk_size < STRINGIO_MAX_CHUNK) chunk_size *= 2;
+        }
+
+        chunk->next = 0;
+        chunk->used = 0;
+        return chunk;
+    }
+
+    // drops chunks that have been read completely, the last one is kept as a spare.
+    void StringIO::release() {
+        while (current && rpos == current->used && current != tail) {
+            current = current->next;
+            rpos    = 0;
+        }
+
+        while (head != current) {
+            Chunk *chunk = head;
+            head = head->next;
+            if (spare) free(spare);
+            spare = chunk;
+        }
+
+        if (current && rpos == current->used)
+            current->used = rpos = 0;
+    }
+
+    // returns space for size bytes at the end of the buffer.
+    char* StringIO::reserve(uint64_t size) {
+        release();
+
+        if (!tail)
+            head = tail = current = allocate(size);
+        else if (tail->size - tail->used < size) {
+            tail->next = allocate(size);
+            tail       = tail->next;
+        }
+
+        return tail->data + tail->used;
     }
 
     void StringIO::write(const char *v, uint64_t size) {
-        if (alloc < wpos + size) {
-            alloc += size*2 + 1;
-            data = (unsigned char*)realloc(data, alloc);
-            if (!data) throw RuntimeError("Out of memory: StringIO");
+        if (tail && tail->size > tail->used) {
+            uint64_t len = tail->size - tail->used;
+            len = len > size ? size : len;
+            memcpy(tail->data + tail->used, v, len);
+            tail->used += len;
+            v    += len;
+            size -= len;
+        }
+
+        if (size > 0) {
+            memcpy(reserve(size), v, size);
+            tail->used += size;
         }
-        memcpy(data+wpos, v, size);
-        wpos += size;
     }
 
     void StringIO::write(const char *v) {
         write(v, strlen(v));
     }
 
+    // formats straight into the buffer, retrying in a large enough chunk when it does not fit.
     void StringIO::writef(const char *fmt, ...) {
-        char buffer[65536];
+        int size;
         va_list ap;
+        uint64_t free = tail ? tail->size - tail->used : 0;
+
         va_start(ap, fmt);
-        uint64_t size = vsnprintf(buffer, 65535, fmt, ap);
+        size = vsnprintf(tail ? tail->data + tail->used : 0, free, fmt, ap);
         va_end(ap);
-        write(buffer, size);
+
+        if (size < 0) throw RuntimeError("Invalid format: StringIO::writef");
+
+        if ((uint64_t)size >= free) {
+            char *buffer = reserve(size + 1);
+            va_start(ap, fmt);
+            vsnprintf(buffer, size + 1, fmt, ap);
+            va_end(ap);
+        }
+
+        tail->used += size;
     }
 
     string& StringIO::read() {
-        if (rpos < wpos) {
-            char buffer[16384];
-            uint64_t max = wpos - rpos, size = max > 16384 ? 16384 : max;
-            memcpy(buffer, data+rpos, size);
-            rpos += size;
-            stringdata = string(buffer, size);
+        const char *chunk;
+        uint64_t size = read(&chunk, 16384);
+        if (size > 0) {
+            stringdata = string(chunk, size);
             return stringdata;
         }
         else return empty;
     }
 
     uint32_t StringIO::read(char *buffer, uint32_t size) {
+        const char *chunk;
+        uint32_t len, total = 0;
+
+        while (total < size && (len = read(&chunk, size - total)) > 0) {
+            memcpy(buffer + total, chunk, len);
+            total += len;
+        }
 
-        if (rpos < wpos) {
-            uint64_t max = wpos - rpos;
-            size = size > max ? max : size;
-            memcpy(buffer, data+rpos, size);
-            rpos += size;
+        return total;
+    }
+
+    uint64_t StringIO::read(const char **buffer, uint64_t size) {
+        release();
+
+        if (current && rpos < current->used) {
+            uint64_t max = current->used - rpos;
+            size    = size > max ? max : size;
+            *buffer = current->data + rpos;
+            rpos   += size;
             return size;
         }
         return 0;
     }
 
-    StringIO::~StringIO() {
-        if (data) free(data);
-        data = 0;
-        wpos = rpos = 0;
+    int StringIO::readv(struct iovec *iov, int count) {
+        int n = 0;
+        release();
+
+        for (Chunk *chunk = current; chunk && n < count; chunk = chunk->next) {
+            uint64_t offset = chunk == current ? rpos : 0;
+            if (chunk->used == offset) continue;
+
+            iov[n].iov_base = chunk->data + offset;
+            iov[n].iov_len  = chunk->used - offset;
+            n++;
+
+            current = chunk;
+            rpos    = chunk->used;
+        }
+
+        return n;
     }
 
-    void StringIO::truncate() {
-        wpos = rpos = 0;
+    uint64_t StringIO::length() {
+        uint64_t size = 0;
+        for (Chunk *chunk = current; chunk; chunk = chunk->next)
+            size += chunk->used - (chunk == current ? rpos : 0);
+        return size;
     }
 
-    bool StringIO::readline(string &line) {
-        if (rpos < wpos) {
-            int c;
-            unsigned char *cursor;
-            uint64_t pos = rpos, size;
+    StringIO::~StringIO() {
+        truncate();
+        if (spare) free(spare);
+        spare = 0;
+    }
 
-            while (pos < wpos && (c = data[pos]) != '\n') pos++;
+    void StringIO::truncate() {
+        while (head) {
+            Chunk *chunk = head;
+            head = head->next;
+            free(chunk);
+        }
 
-            cursor = data + rpos;
-            size   = pos - rpos;
-            rpos   = pos + 1;
+        head = tail = current = 0;
+        rpos = 0;
+    }
 
-            line = string((char*)cursor, size);
-            return true;
+    bool StringIO::readline(string &line) {
+        bool found = false;
+        line.clear();
+
+        release();
+        if (!current || rpos == current->used) return false;
+
+        while (!found) {
+            char *start = current->data + rpos, *end;
+            uint64_t size = current->used - rpos;
+
+            if ((end = (char*)memchr(start, '\n', size))) {
+                size  = end - start;
+                found = true;
+            }
+
+            line.append(start, size);
+            rpos += found ? size + 1 : size;
+
+            // lines can span chunks.
+            if (!found) {
+                if (current == tail) break;
+                current = current->next;
+                rpos    = 0;
+            }
         }
 
-        return false;
+        return true;
     }
 
     char* StringIO::readline() {
@@ -0,0 +1,135 @@
+#include "dbic++.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// rows are appended to the io object once this much has been buffered.
+#define TSV_FLUSH_SIZE 65536
+
+namespace dbi {
+
+    // escape sequence for a byte, 0 if it can be copied as is.
+    static inline const char* TSV_ESCAPE(char c) {
+        switch (c) {
+            case '\\': return "\\\\";
+            case '\t': return "\\t";
+            case '\n': return "\\n";
+            case '\r': return "\\r";
+            case '\0': return "\\0";
+            default:   return 0;
+        }
+    }
+
+    // index of the next byte that needs escaping, or length if there is none.
+    static inline uint64_t TSV_SCAN(const char *data, uint64_t n, uint64_t length) {
+#ifdef __SSE2__
+        const __m128i backslash = _mm_set1_epi8('\\'), tab = _mm_set1_epi8('\t'),
+                      newline   = _mm_set1_epi8('\n'), cr  = _mm_set1_epi8('\r'),
+                      nul       = _mm_setzero_si128();
+
+        for (; n + 16 <= length; n += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(data + n));
+            __m128i m = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, backslash), _mm_cmpeq_epi8(v, tab)),
+                _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, newline), _mm_cmpeq_epi8(v, cr)),
+                             _mm_cmpeq_epi8(v, nul)));
+            int mask = _mm_movemask_epi8(m);
+            if (mask) return n + __builtin_ctz(mask);
+        }
+#endif
+        while (n < length && !TSV_ESCAPE(data[n])) n++;
+        return n;
+    }
+
+    void escapeTsv(string &out, const char *data, uint64_t length) {
+        uint64_t start = 0, n = 0;
+
+        while ((n = TSV_SCAN(data, n, length)) < length) {
+            out.append(data + start, n - start);
+            out.append(TSV_ESCAPE(data[n]), 2);
+            start = ++n;
+        }
+
+        out.append(data + start, length - start);
+    }
+
+    // bytea hex format, the backslash is doubled for the COPY text format.
+    static void TSV_HEX(string &out, const char *data, uint64_t length) {
+        static const char digits[] = "0123456789abcdef";
+        uint64_t offset = out.length();
+
+        out.resize(offset + 3 + length * 2);
+        out[offset++] = '\\';
+        out[offset++] = '\\';
+        out[offset++] = 'x';
+
+        for (uint64_t n = 0; n < length; n++) {
+            out[offset++] = digits[(unsigned char)data[n] >> 4];
+            out[offset++] = digits[(unsigned char)data[n] & 0x0f];
+        }
+    }
+
+    TsvWriter::TsvWriter(IO *io, bool hex) {
+        this->io  = io;
+        this->hex = hex;
+        nrows     = 0;
+        column    = 0;
+        buffer.reserve(TSV_FLUSH_SIZE * 2);
+    }
+
+    TsvWriter::~TsvWriter() {
+        try {
+            flush();
+        }
+        catch (...) {
+        }
+    }
+
+    void TsvWriter::separate() {
+        if (column++ > 0) buffer += '\t';
+    }
+
+    void TsvWriter::write(Param &p) {
+        if (hex && p.binary && !p.isnull) {
+            separate();
+            TSV_HEX(buffer, p.value.data(), p.value.length());
+        }
+        else
+            write(p.isnull ? 0 : p.value.data(), p.value.length());
+    }
+
+    void TsvWriter::write(const char *data, uint64_t length) {
+        separate();
+        if (data)
+            escapeTsv(buffer, data, length);
+        else
+            buffer.append("\\N", 2);
+    }
+
+    void TsvWriter::write(ResultRow &row) {
+        for (int n = 0; n < row.size(); n++)
+            write(row[n]);
+        end();
+    }
+
+    void TsvWriter::end() {
+        buffer += '\n';
+        column  = 0;
+        nrows++;
+
+        if (buffer.length() >= TSV_FLUSH_SIZE)
+            flush();
+    }
+
+    void TsvWriter::flush() {
+        if (buffer.length() > 0) {
+            io->write(buffer.data(), buffer.length());
+            buffer.clear();
+        }
+    }
+
+    uint64_t TsvWriter::rows() {
+        return nrows;
+    }
+}
@@ -0,0 +1,133 @@
+#include "dbic++.h"
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+namespace dbi {
+
+    // parses up to n digits, returns number of digits consumed.
+    static int parseDigits(unsigned char *&p, unsigned char *end, int n, int *rv) {
+        int i;
+        for (*rv = 0, i = 0; i < n && p < end && *p >= '0' && *p <= '9'; i++, p++)
+            *rv = *rv * 10 + (*p - '0');
+        return i;
+    }
+
+    // YYYY-MM-DD, HH:MM:SS[.ffffff] or YYYY-MM-DD HH:MM:SS[.ffffff][+-HH[:MM]]
+    static void parseTimestamp(unsigned char *p, unsigned char *end, Timestamp &t) {
+        int digits;
+        memset(&t, 0, sizeof(Timestamp));
+
+        unsigned char *s = p;
+        while (s < end && *s >= '0' && *s <= '9') s++;
+
+        if (s < end && *s == '-') {
+            parseDigits(p, end, 8, &t.year);
+            p++; parseDigits(p, end, 2, &t.month);
+            p++; parseDigits(p, end, 2, &t.day);
+            if (p >= end || (*p != ' ' && *p != 'T')) return;
+            p++;
+        }
+
+        parseDigits(p, end, 9, &t.hour);
+        if (p < end && *p == ':') { p++; parseDigits(p, end, 2, &t.minute); }
+        if (p < end && *p == ':') { p++; parseDigits(p, end, 2, &t.second); }
+
+        if (p < end && *p == '.') {
+            p++;
+            digits = parseDigits(p, end, 6, &t.usec);
+            while (digits++ < 6) t.usec *= 10;
+            while (p < end && *p >= '0' && *p <= '9') p++;
+        }
+
+        if (p < end && (*p == '+' || *p == '-')) {
+            int sign = *p++ == '-' ? -1 : 1, hours = 0, minutes = 0;
+            parseDigits(p, end, 2, &hours);
+            if (p < end && *p == ':') p++;
+            parseDigits(p, end, 2, &minutes);
+            t.tzoffset = sign * (hours * 3600 + minutes * 60);
+        }
+    }
+
+    void parseValue(int type, unsigned char *data, uint64_t length, Value &v) {
+        char number[64];
+
+        v.type   = type;
+        v.data   = data;
+        v.length = data ? length : 0;
+        v.isnull = data == 0;
+
+        if (v.isnull) return;
+
+        switch (type) {
+            case DBI_TYPE_INT:
+            case DBI_TYPE_FLOAT:
+                length = length < sizeof(number) - 1 ? length : sizeof(number) - 1;
+                memcpy(number, data, length);
+                number[length] = 0;
+                if (type == DBI_TYPE_INT)
+                    v.i = strtoll(number, 0, 10);
+                else
+                    v.f = strtod(number, 0);
+                break;
+            case DBI_TYPE_BOOLEAN:
+                // numeric booleans (mysql tinyint(1)) keep their value, otherwise t, y or 1 is true.
+                if (length > 0 && ((data[0] >= '0' && data[0] <= '9') || data[0] == '-')) {
+                    length = length < sizeof(number) - 1 ? length : sizeof(number) - 1;
+                    memcpy(number, data, length);
+                    number[length] = 0;
+                    v.i = strtoll(number, 0, 10);
+                }
+                else
+                    v.i = length > 0 && (data[0] == 't' || data[0] == 'T' || data[0] == 'y' || data[0] == 'Y');
+                break;
+            case DBI_TYPE_TIME:
+            case DBI_TYPE_DATE:
+            case DBI_TYPE_TIMESTAMP:
+                parseTimestamp(data, data + length, v.t);
+                break;
+        }
+    }
+
+    int formatValue(Value &v, char *buffer, size_t size) {
+        int n = 0;
+        Timestamp &t = v.t;
+
+        if (v.isnull) {
+            buffer[0] = 0;
+            return 0;
+        }
+
+        switch (v.type) {
+            case DBI_TYPE_INT:
+            case DBI_TYPE_BOOLEAN:
+                return snprintf(buffer, size, "%" PRIi64, v.i);
+            case DBI_TYPE_FLOAT:
+                return snprintf(buffer, size, "%f", v.f);
+            case DBI_TYPE_DATE:
+                return snprintf(buffer, size, "%04d-%02d-%02d", t.year, t.month, t.day);
+            case DBI_TYPE_TIME:
+                n = snprintf(buffer, size, "%02d:%02d:%02d", t.hour, t.minute, t.second);
+                break;
+            case DBI_TYPE_TIMESTAMP:
+                n = snprintf(buffer, size, "%04d-%02d-%02d %02d:%02d:%02d",
+                             t.year, t.month, t.day, t.hour, t.minute, t.second);
+                break;
+            default:
+                n = v.length < size ? v.length : size - 1;
+                memcpy(buffer, v.data, n);
+                buffer[n] = 0;
+                return n;
+        }
+
+        if (t.usec && n > 0 && (size_t)n < size)
+            n += snprintf(buffer + n, size - n, ".%06d", t.usec);
+        if (t.tzoffset && n > 0 && (size_t)n < size) {
+            int offset = t.tzoffset < 0 ? -t.tzoffset : t.tzoffset;
+            n += snprintf(buffer + n, size - n, "%c%02d:%02d", t.tzoffset < 0 ? '-' : '+',
+                          offset / 3600, (offset % 3600) / 60);
+        }
+
+        return n;
+    }
+}